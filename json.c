@@ -9,19 +9,90 @@
 #include "json.h"
 #include <assert.h>
 #include <errno.h>   /* errno, ERANGE */
+#include <float.h>   /* FLT_EVAL_METHOD */
 #include <math.h>    /* HUGE_VAL */
+#include <stdint.h>  /* uint64_t */
 #include <stdlib.h>  /* NULL, malloc(), realloc(), free(), strtod() */
 #include <string.h>  /* memcpy() */
+#include <fcntl.h>   /* open() */
+#ifdef _WIN32
+#include <io.h>      /* _write(), _read() */
+#else
+#include <sys/mman.h> /* mmap() */
+#include <sys/stat.h> /* fstat() */
+#include <unistd.h>  /* write(), read() */
+#endif
+
+/* 多线程批量解析使用 pthread, 定义 JSON_NO_THREADS 则在调用线程内串行完成 */
+#if defined(_WIN32) && !defined(JSON_NO_THREADS)
+#define JSON_NO_THREADS
+#endif
+#ifndef JSON_NO_THREADS
+#include <pthread.h>
+#endif
+
+/* 编译期按目标指令集选择 SIMD 实现, 定义 JSON_NO_SIMD 可强制使用标量版本 */
+#ifndef JSON_NO_SIMD
+#if defined(__AVX2__)
+#define JSON_SIMD_AVX2
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JSON_SIMD_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define JSON_SIMD_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+#if defined(__PCLMUL__) && defined(JSON_SIMD_SSE2)
+#define JSON_SIMD_PCLMUL
+#include <wmmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+static unsigned json_ctz(unsigned x) { unsigned long i; _BitScanForward(&i, x); return (unsigned)i; }
+static unsigned json_ctz64(uint64_t x) { unsigned long i; _BitScanForward64(&i, x); return (unsigned)i; }
+#define json_popcount64(x) ((unsigned)__popcnt64(x))
+#else
+#define json_ctz(x) ((unsigned)__builtin_ctz(x))
+#define json_ctz64(x) ((unsigned)__builtin_ctzll(x))
+#define json_popcount64(x) ((unsigned)__builtin_popcountll(x))
+#endif
 
 #ifndef JSON_PARSE_STACK_INIT_SIZE
 #define JSON_PARSE_STACK_INIT_SIZE 256
 #endif
 
+#ifndef JSON_ARENA_CHUNK_SIZE
+#define JSON_ARENA_CHUNK_SIZE 4096
+#endif
+
+#ifndef JSON_OBJECT_INDEX_THRESHOLD
+#define JSON_OBJECT_INDEX_THRESHOLD 16
+#endif
+
+#ifndef JSON_SINK_BUFFER_SIZE
+#define JSON_SINK_BUFFER_SIZE 4096
+#endif
+
+#ifndef JSON_NDJSON_BATCH
+#define JSON_NDJSON_BATCH 64 /* 工作线程每次领取的记录数 */
+#endif
+
+#ifndef JSON_PARALLEL_MIN_SEGMENT
+#define JSON_PARALLEL_MIN_SEGMENT 65536 /* 每个线程至少分到的字节数, 太小时线程开销大于收益 */
+#endif
+
 #ifndef LEPT_PARSE_STRINGIFY_INIT_SIZE
 #define LEPT_PARSE_STRINGIFY_INIT_SIZE 256
 #endif
 
 #define EXPECT(c, ch)       do { assert(*c->json == (ch)); c->json++; } while(0)
+/* 输入以 end 为界, 不要求 '\0' 结尾; 越界时视为 '\0' */
+#define PEEK(p, end)        ((p) < (end) ? *(p) : '\0')
 
 #define ISDIGIT(ch)         ((ch) >= '0' && (ch) <= '9')
 #define ISDIGIT1TO9(ch)     ((ch) >= '1' && (ch) <= '9')
@@ -31,17 +102,114 @@
 #define PUTS(c, s, len)     memcpy(json_context_push(c, len), s, len)
 
 
-typedef struct {
+struct json_context {
     const char* json;
+    const char* end; /* json 的结尾, 解析不会越过它 */
     char* stack;
     size_t size; /* 当前容量 */
     size_t top;  /* 栈顶 */
-}json_context;
+    json_arena* arena; /* 非 NULL 时节点/键/字符串从 arena 分配 */
+    int insitu; /* 字符串/键原地解码, 指向输入缓冲区 */
+    json_write_fn sink; /* 非 NULL 时 stack 是输出缓冲区, 写满即交给 sink */
+    void* sink_user;
+    int sink_error; /* sink 返回过非 0, 之后的输出都丢弃 */
+    struct json_projection* projection; /* 非 NULL 时 json_parse_object()/json_parse_array() 跳过不需要的值 */
+};
+
+typedef struct {
+    const char* key; /* 反转义后的段 */
+    size_t klen;
+    size_t index; /* 合法的数组下标, 否则为 JSON_KEY_NOT_EXIST */
+}json_pointer_token;
+
+struct json_pointer {
+    size_t count;
+    json_pointer_token* tokens;
+};
+
+/* 投影解析: 只构建 paths 经过或以其为前缀的节点 */
+struct json_projection {
+    json_pointer* const* paths;
+    size_t count;
+    size_t* matched; /* 每条路径已匹配的段数, 等于 depth 的路径在当前容器上仍然有效 */
+    size_t depth; /* 当前容器的深度 */
+};
+
+struct json_arena_chunk {
+    struct json_arena_chunk* next;
+    size_t size; /* data 容量, data 紧跟在结构体之后 */
+};
+
+/* bump allocator: 8 字节对齐, 当前块不足时申请一个两倍大小的新块 */
+static void* json_arena_alloc(json_arena* arena, size_t size) {
+    struct json_arena_chunk* chunk = arena->chunk;
+    void* ret;
+    size = (size + 7) & ~(size_t)7;
+    if (chunk == NULL || arena->used + size > chunk->size) {
+        size_t cap = chunk ? chunk->size << 1 : JSON_ARENA_CHUNK_SIZE;
+        while (cap < size)
+            cap <<= 1;
+        chunk = (struct json_arena_chunk*)malloc(sizeof(struct json_arena_chunk) + cap);
+        chunk->next = arena->chunk;
+        chunk->size = cap;
+        arena->chunk = chunk;
+        arena->used = 0;
+    }
+    ret = (char*)(chunk + 1) + arena->used;
+    arena->used += size;
+    return ret;
+}
+
+void json_arena_init(json_arena* arena) {
+    assert(arena != NULL);
+    arena->chunk = NULL;
+    arena->used = 0;
+}
+
+/* 只保留最大的块, 下一个文档可直接复用 */
+void json_arena_reset(json_arena* arena) {
+    struct json_arena_chunk* chunk;
+    assert(arena != NULL);
+    if (arena->chunk == NULL)
+        return;
+    chunk = arena->chunk->next;
+    while (chunk) {
+        struct json_arena_chunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    arena->chunk->next = NULL;
+    arena->used = 0;
+}
+
+void json_arena_free(json_arena* arena) {
+    json_arena_reset(arena);
+    free(arena->chunk);
+    arena->chunk = NULL;
+}
+
+static void* json_context_alloc(json_context* context, size_t size) {
+    return context->arena ? json_arena_alloc(context->arena, size) : malloc(size);
+}
+
+/* arena 中的值随 arena 一起释放 */
+static void json_context_free_value(json_context* context, json_value* value) {
+    if (context->arena == NULL)
+        json_free(value);
+}
+
+static void json_context_flush(json_context* context) {
+    if (context->top && !context->sink_error && context->sink(context->sink_user, context->stack, context->top))
+        context->sink_error = true;
+    context->top = 0;
+}
 
 /* stack */
 static void* json_context_push(json_context* context, size_t size) {
     void* ret;
     assert(size > 0);
+    if (context->top + size >= context->size && context->sink)
+        json_context_flush(context);
     if (context->top + size >= context->size) {
         if (context->size == 0){ /* init */
             context->size = JSON_PARSE_STACK_INIT_SIZE;
@@ -61,19 +229,92 @@ static void* json_context_pop(json_context* context, size_t size) {
     return context->stack + (context->top -= size);
 }
 
-/* ws = *(%x20 / %x09 / %x0A / %x0D) */
-static void json_parse_whitespace(json_context* context) {
-    const char *p = context->json;
-    while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') {
+#define ISWS(ch)            ((ch) == ' ' || (ch) == '\t' || (ch) == '\n' || (ch) == '\r')
+
+/* 返回 [p, end) 中第一个 '"', '\\' 或控制字符 (< 0x20) 的位置, 没有则返回 end */
+static const char* json_scan_string(const char* p, const char* end) {
+#if defined(JSON_SIMD_AVX2)
+    const __m256i quote32 = _mm256_set1_epi8('"'), slash32 = _mm256_set1_epi8('\\'), ctrl32 = _mm256_set1_epi8(0x1F);
+    while (end - p >= 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)p);
+        __m256i m = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(x, quote32), _mm256_cmpeq_epi8(x, slash32)),
+                                    _mm256_cmpeq_epi8(_mm256_min_epu8(x, ctrl32), x));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(m);
+        if (mask)
+            return p + json_ctz(mask);
+        p += 32;
+    }
+#endif
+#if defined(JSON_SIMD_SSE2)
+    const __m128i quote = _mm_set1_epi8('"'), slash = _mm_set1_epi8('\\'), ctrl = _mm_set1_epi8(0x1F);
+    while (end - p >= 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)p);
+        /* min(x, 0x1F) == x 即 x <= 0x1F (无符号) */
+        __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, quote), _mm_cmpeq_epi8(x, slash)),
+                                 _mm_cmpeq_epi8(_mm_min_epu8(x, ctrl), x));
+        unsigned mask = (unsigned)_mm_movemask_epi8(m);
+        if (mask)
+            return p + json_ctz(mask);
+        p += 16;
+    }
+#elif defined(JSON_SIMD_NEON)
+    const uint8x16_t quote = vdupq_n_u8('"'), slash = vdupq_n_u8('\\'), ctrl = vdupq_n_u8(0x1F);
+    while (end - p >= 16) {
+        uint8x16_t x = vld1q_u8((const uint8_t*)p);
+        uint8x16_t m = vorrq_u8(vorrq_u8(vceqq_u8(x, quote), vceqq_u8(x, slash)), vcleq_u8(x, ctrl));
+        if (vmaxvq_u8(m))
+            break; /* 命中位置交给下面的标量循环 */
+        p += 16;
+    }
+#endif
+    while (p < end && *p != '"' && *p != '\\' && (unsigned char)*p >= 0x20)
         p++;
+    return p;
+}
+
+/* ws = *(%x20 / %x09 / %x0A / %x0D) */
+static const char* json_skip_whitespace(const char* p, const char* end) {
+    /* 紧凑的 JSON 多数情况下没有空白, 先走标量判断 */
+    if (p == end || !ISWS(*p))
+        return p;
+#if defined(JSON_SIMD_SSE2)
+    {
+        const __m128i sp = _mm_set1_epi8(' '), tab = _mm_set1_epi8('\t'), lf = _mm_set1_epi8('\n'), cr = _mm_set1_epi8('\r');
+        while (end - p >= 16) {
+            __m128i x = _mm_loadu_si128((const __m128i*)p);
+            __m128i m = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, sp), _mm_cmpeq_epi8(x, tab)),
+                                     _mm_or_si128(_mm_cmpeq_epi8(x, lf), _mm_cmpeq_epi8(x, cr)));
+            unsigned mask = (unsigned)_mm_movemask_epi8(m) ^ 0xFFFF; /* 非空白字符 */
+            if (mask)
+                return p + json_ctz(mask);
+            p += 16;
+        }
     }
-    context->json = p;
+#elif defined(JSON_SIMD_NEON)
+    {
+        const uint8x16_t sp = vdupq_n_u8(' '), tab = vdupq_n_u8('\t'), lf = vdupq_n_u8('\n'), cr = vdupq_n_u8('\r');
+        while (end - p >= 16) {
+            uint8x16_t x = vld1q_u8((const uint8_t*)p);
+            uint8x16_t m = vorrq_u8(vorrq_u8(vceqq_u8(x, sp), vceqq_u8(x, tab)), vorrq_u8(vceqq_u8(x, lf), vceqq_u8(x, cr)));
+            if (vminvq_u8(m) == 0)
+                break;
+            p += 16;
+        }
+    }
+#endif
+    while (p < end && ISWS(*p))
+        p++;
+    return p;
+}
+
+static void json_parse_whitespace(json_context* context) {
+    context->json = json_skip_whitespace(context->json, context->end);
 }
 
 static int json_parse_literal(json_context* context, json_value* value, const char* literal, json_type type) {
     assert(*context->json == literal[0]);
     size_t len = strlen(literal);
-    if (strncmp(context->json, literal, len)) {
+    if ((size_t)(context->end - context->json) < len || memcmp(context->json, literal, len)) {
         return JSON_PARSE_INVALID_VALUE;
     }
     context->json += len;
@@ -81,44 +322,536 @@ static int json_parse_literal(json_context* context, json_value* value, const ch
     return JSON_PARSE_OK;
 }
 
+/* 5^q 归一化到 [2^127, 2^128) 的 128 位近似值 (高 64 位, 低 64 位), q = -342 ... 308 */
+/* q < 0 时向上取整, q >= 0 时截断, q <= 55 时精确 */
+#define JSON_POW5_MIN_EXP (-342)
+#define JSON_POW5_MAX_EXP 308
+static const uint64_t json_pow5_table[][2] = {
+    { 0xEEF453D6923BD65A, 0x113FAA2906A13B3F }, { 0x9558B4661B6565F8, 0x4AC7CA59A424C507 },
+    { 0xBAAEE17FA23EBF76, 0x5D79BCF00D2DF649 }, { 0xE95A99DF8ACE6F53, 0xF4D82C2C107973DC },
+    { 0x91D8A02BB6C10594, 0x79071B9B8A4BE869 }, { 0xB64EC836A47146F9, 0x9748E2826CDEE284 },
+    { 0xE3E27A444D8D98B7, 0xFD1B1B2308169B25 }, { 0x8E6D8C6AB0787F72, 0xFE30F0F5E50E20F7 },
+    { 0xB208EF855C969F4F, 0xBDBD2D335E51A935 }, { 0xDE8B2B66B3BC4723, 0xAD2C788035E61382 },
+    { 0x8B16FB203055AC76, 0x4C3BCB5021AFCC31 }, { 0xADDCB9E83C6B1793, 0xDF4ABE242A1BBF3D },
+    { 0xD953E8624B85DD78, 0xD71D6DAD34A2AF0D }, { 0x87D4713D6F33AA6B, 0x8672648C40E5AD68 },
+    { 0xA9C98D8CCB009506, 0x680EFDAF511F18C2 }, { 0xD43BF0EFFDC0BA48, 0x0212BD1B2566DEF2 },
+    { 0x84A57695FE98746D, 0x014BB630F7604B57 }, { 0xA5CED43B7E3E9188, 0x419EA3BD35385E2D },
+    { 0xCF42894A5DCE35EA, 0x52064CAC828675B9 }, { 0x818995CE7AA0E1B2, 0x7343EFEBD1940993 },
+    { 0xA1EBFB4219491A1F, 0x1014EBE6C5F90BF8 }, { 0xCA66FA129F9B60A6, 0xD41A26E077774EF6 },
+    { 0xFD00B897478238D0, 0x8920B098955522B4 }, { 0x9E20735E8CB16382, 0x55B46E5F5D5535B0 },
+    { 0xC5A890362FDDBC62, 0xEB2189F734AA831D }, { 0xF712B443BBD52B7B, 0xA5E9EC7501D523E4 },
+    { 0x9A6BB0AA55653B2D, 0x47B233C92125366E }, { 0xC1069CD4EABE89F8, 0x999EC0BB696E840A },
+    { 0xF148440A256E2C76, 0xC00670EA43CA250D }, { 0x96CD2A865764DBCA, 0x380406926A5E5728 },
+    { 0xBC807527ED3E12BC, 0xC605083704F5ECF2 }, { 0xEBA09271E88D976B, 0xF7864A44C633682E },
+    { 0x93445B8731587EA3, 0x7AB3EE6AFBE0211D }, { 0xB8157268FDAE9E4C, 0x5960EA05BAD82964 },
+    { 0xE61ACF033D1A45DF, 0x6FB92487298E33BD }, { 0x8FD0C16206306BAB, 0xA5D3B6D479F8E056 },
+    { 0xB3C4F1BA87BC8696, 0x8F48A4899877186C }, { 0xE0B62E2929ABA83C, 0x331ACDABFE94DE87 },
+    { 0x8C71DCD9BA0B4925, 0x9FF0C08B7F1D0B14 }, { 0xAF8E5410288E1B6F, 0x07ECF0AE5EE44DD9 },
+    { 0xDB71E91432B1A24A, 0xC9E82CD9F69D6150 }, { 0x892731AC9FAF056E, 0xBE311C083A225CD2 },
+    { 0xAB70FE17C79AC6CA, 0x6DBD630A48AAF406 }, { 0xD64D3D9DB981787D, 0x092CBBCCDAD5B108 },
+    { 0x85F0468293F0EB4E, 0x25BBF56008C58EA5 }, { 0xA76C582338ED2621, 0xAF2AF2B80AF6F24E },
+    { 0xD1476E2C07286FAA, 0x1AF5AF660DB4AEE1 }, { 0x82CCA4DB847945CA, 0x50D98D9FC890ED4D },
+    { 0xA37FCE126597973C, 0xE50FF107BAB528A0 }, { 0xCC5FC196FEFD7D0C, 0x1E53ED49A96272C8 },
+    { 0xFF77B1FCBEBCDC4F, 0x25E8E89C13BB0F7A }, { 0x9FAACF3DF73609B1, 0x77B191618C54E9AC },
+    { 0xC795830D75038C1D, 0xD59DF5B9EF6A2417 }, { 0xF97AE3D0D2446F25, 0x4B0573286B44AD1D },
+    { 0x9BECCE62836AC577, 0x4EE367F9430AEC32 }, { 0xC2E801FB244576D5, 0x229C41F793CDA73F },
+    { 0xF3A20279ED56D48A, 0x6B43527578C1110F }, { 0x9845418C345644D6, 0x830A13896B78AAA9 },
+    { 0xBE5691EF416BD60C, 0x23CC986BC656D553 }, { 0xEDEC366B11C6CB8F, 0x2CBFBE86B7EC8AA8 },
+    { 0x94B3A202EB1C3F39, 0x7BF7D71432F3D6A9 }, { 0xB9E08A83A5E34F07, 0xDAF5CCD93FB0CC53 },
+    { 0xE858AD248F5C22C9, 0xD1B3400F8F9CFF68 }, { 0x91376C36D99995BE, 0x23100809B9C21FA1 },
+    { 0xB58547448FFFFB2D, 0xABD40A0C2832A78A }, { 0xE2E69915B3FFF9F9, 0x16C90C8F323F516C },
+    { 0x8DD01FAD907FFC3B, 0xAE3DA7D97F6792E3 }, { 0xB1442798F49FFB4A, 0x99CD11CFDF41779C },
+    { 0xDD95317F31C7FA1D, 0x40405643D711D583 }, { 0x8A7D3EEF7F1CFC52, 0x482835EA666B2572 },
+    { 0xAD1C8EAB5EE43B66, 0xDA3243650005EECF }, { 0xD863B256369D4A40, 0x90BED43E40076A82 },
+    { 0x873E4F75E2224E68, 0x5A7744A6E804A291 }, { 0xA90DE3535AAAE202, 0x711515D0A205CB36 },
+    { 0xD3515C2831559A83, 0x0D5A5B44CA873E03 }, { 0x8412D9991ED58091, 0xE858790AFE9486C2 },
+    { 0xA5178FFF668AE0B6, 0x626E974DBE39A872 }, { 0xCE5D73FF402D98E3, 0xFB0A3D212DC8128F },
+    { 0x80FA687F881C7F8E, 0x7CE66634BC9D0B99 }, { 0xA139029F6A239F72, 0x1C1FFFC1EBC44E80 },
+    { 0xC987434744AC874E, 0xA327FFB266B56220 }, { 0xFBE9141915D7A922, 0x4BF1FF9F0062BAA8 },
+    { 0x9D71AC8FADA6C9B5, 0x6F773FC3603DB4A9 }, { 0xC4CE17B399107C22, 0xCB550FB4384D21D3 },
+    { 0xF6019DA07F549B2B, 0x7E2A53A146606A48 }, { 0x99C102844F94E0FB, 0x2EDA7444CBFC426D },
+    { 0xC0314325637A1939, 0xFA911155FEFB5308 }, { 0xF03D93EEBC589F88, 0x793555AB7EBA27CA },
+    { 0x96267C7535B763B5, 0x4BC1558B2F3458DE }, { 0xBBB01B9283253CA2, 0x9EB1AAEDFB016F16 },
+    { 0xEA9C227723EE8BCB, 0x465E15A979C1CADC }, { 0x92A1958A7675175F, 0x0BFACD89EC191EC9 },
+    { 0xB749FAED14125D36, 0xCEF980EC671F667B }, { 0xE51C79A85916F484, 0x82B7E12780E7401A },
+    { 0x8F31CC0937AE58D2, 0xD1B2ECB8B0908810 }, { 0xB2FE3F0B8599EF07, 0x861FA7E6DCB4AA15 },
+    { 0xDFBDCECE67006AC9, 0x67A791E093E1D49A }, { 0x8BD6A141006042BD, 0xE0C8BB2C5C6D24E0 },
+    { 0xAECC49914078536D, 0x58FAE9F773886E18 }, { 0xDA7F5BF590966848, 0xAF39A475506A899E },
+    { 0x888F99797A5E012D, 0x6D8406C952429603 }, { 0xAAB37FD7D8F58178, 0xC8E5087BA6D33B83 },
+    { 0xD5605FCDCF32E1D6, 0xFB1E4A9A90880A64 }, { 0x855C3BE0A17FCD26, 0x5CF2EEA09A55067F },
+    { 0xA6B34AD8C9DFC06F, 0xF42FAA48C0EA481E }, { 0xD0601D8EFC57B08B, 0xF13B94DAF124DA26 },
+    { 0x823C12795DB6CE57, 0x76C53D08D6B70858 }, { 0xA2CB1717B52481ED, 0x54768C4B0C64CA6E },
+    { 0xCB7DDCDDA26DA268, 0xA9942F5DCF7DFD09 }, { 0xFE5D54150B090B02, 0xD3F93B35435D7C4C },
+    { 0x9EFA548D26E5A6E1, 0xC47BC5014A1A6DAF }, { 0xC6B8E9B0709F109A, 0x359AB6419CA1091B },
+    { 0xF867241C8CC6D4C0, 0xC30163D203C94B62 }, { 0x9B407691D7FC44F8, 0x79E0DE63425DCF1D },
+    { 0xC21094364DFB5636, 0x985915FC12F542E4 }, { 0xF294B943E17A2BC4, 0x3E6F5B7B17B2939D },
+    { 0x979CF3CA6CEC5B5A, 0xA705992CEECF9C42 }, { 0xBD8430BD08277231, 0x50C6FF782A838353 },
+    { 0xECE53CEC4A314EBD, 0xA4F8BF5635246428 }, { 0x940F4613AE5ED136, 0x871B7795E136BE99 },
+    { 0xB913179899F68584, 0x28E2557B59846E3F }, { 0xE757DD7EC07426E5, 0x331AEADA2FE589CF },
+    { 0x9096EA6F3848984F, 0x3FF0D2C85DEF7621 }, { 0xB4BCA50B065ABE63, 0x0FED077A756B53A9 },
+    { 0xE1EBCE4DC7F16DFB, 0xD3E8495912C62894 }, { 0x8D3360F09CF6E4BD, 0x64712DD7ABBBD95C },
+    { 0xB080392CC4349DEC, 0xBD8D794D96AACFB3 }, { 0xDCA04777F541C567, 0xECF0D7A0FC5583A0 },
+    { 0x89E42CAAF9491B60, 0xF41686C49DB57244 }, { 0xAC5D37D5B79B6239, 0x311C2875C522CED5 },
+    { 0xD77485CB25823AC7, 0x7D633293366B828B }, { 0x86A8D39EF77164BC, 0xAE5DFF9C02033197 },
+    { 0xA8530886B54DBDEB, 0xD9F57F830283FDFC }, { 0xD267CAA862A12D66, 0xD072DF63C324FD7B },
+    { 0x8380DEA93DA4BC60, 0x4247CB9E59F71E6D }, { 0xA46116538D0DEB78, 0x52D9BE85F074E608 },
+    { 0xCD795BE870516656, 0x67902E276C921F8B }, { 0x806BD9714632DFF6, 0x00BA1CD8A3DB53B6 },
+    { 0xA086CFCD97BF97F3, 0x80E8A40ECCD228A4 }, { 0xC8A883C0FDAF7DF0, 0x6122CD128006B2CD },
+    { 0xFAD2A4B13D1B5D6C, 0x796B805720085F81 }, { 0x9CC3A6EEC6311A63, 0xCBE3303674053BB0 },
+    { 0xC3F490AA77BD60FC, 0xBEDBFC4411068A9C }, { 0xF4F1B4D515ACB93B, 0xEE92FB5515482D44 },
+    { 0x991711052D8BF3C5, 0x751BDD152D4D1C4A }, { 0xBF5CD54678EEF0B6, 0xD262D45A78A0635D },
+    { 0xEF340A98172AACE4, 0x86FB897116C87C34 }, { 0x9580869F0E7AAC0E, 0xD45D35E6AE3D4DA0 },
+    { 0xBAE0A846D2195712, 0x8974836059CCA109 }, { 0xE998D258869FACD7, 0x2BD1A438703FC94B },
+    { 0x91FF83775423CC06, 0x7B6306A34627DDCF }, { 0xB67F6455292CBF08, 0x1A3BC84C17B1D542 },
+    { 0xE41F3D6A7377EECA, 0x20CABA5F1D9E4A93 }, { 0x8E938662882AF53E, 0x547EB47B7282EE9C },
+    { 0xB23867FB2A35B28D, 0xE99E619A4F23AA43 }, { 0xDEC681F9F4C31F31, 0x6405FA00E2EC94D4 },
+    { 0x8B3C113C38F9F37E, 0xDE83BC408DD3DD04 }, { 0xAE0B158B4738705E, 0x9624AB50B148D445 },
+    { 0xD98DDAEE19068C76, 0x3BADD624DD9B0957 }, { 0x87F8A8D4CFA417C9, 0xE54CA5D70A80E5D6 },
+    { 0xA9F6D30A038D1DBC, 0x5E9FCF4CCD211F4C }, { 0xD47487CC8470652B, 0x7647C3200069671F },
+    { 0x84C8D4DFD2C63F3B, 0x29ECD9F40041E073 }, { 0xA5FB0A17C777CF09, 0xF468107100525890 },
+    { 0xCF79CC9DB955C2CC, 0x7182148D4066EEB4 }, { 0x81AC1FE293D599BF, 0xC6F14CD848405530 },
+    { 0xA21727DB38CB002F, 0xB8ADA00E5A506A7C }, { 0xCA9CF1D206FDC03B, 0xA6D90811F0E4851C },
+    { 0xFD442E4688BD304A, 0x908F4A166D1DA663 }, { 0x9E4A9CEC15763E2E, 0x9A598E4E043287FE },
+    { 0xC5DD44271AD3CDBA, 0x40EFF1E1853F29FD }, { 0xF7549530E188C128, 0xD12BEE59E68EF47C },
+    { 0x9A94DD3E8CF578B9, 0x82BB74F8301958CE }, { 0xC13A148E3032D6E7, 0xE36A52363C1FAF01 },
+    { 0xF18899B1BC3F8CA1, 0xDC44E6C3CB279AC1 }, { 0x96F5600F15A7B7E5, 0x29AB103A5EF8C0B9 },
+    { 0xBCB2B812DB11A5DE, 0x7415D448F6B6F0E7 }, { 0xEBDF661791D60F56, 0x111B495B3464AD21 },
+    { 0x936B9FCEBB25C995, 0xCAB10DD900BEEC34 }, { 0xB84687C269EF3BFB, 0x3D5D514F40EEA742 },
+    { 0xE65829B3046B0AFA, 0x0CB4A5A3112A5112 }, { 0x8FF71A0FE2C2E6DC, 0x47F0E785EABA72AB },
+    { 0xB3F4E093DB73A093, 0x59ED216765690F56 }, { 0xE0F218B8D25088B8, 0x306869C13EC3532C },
+    { 0x8C974F7383725573, 0x1E414218C73A13FB }, { 0xAFBD2350644EEACF, 0xE5D1929EF90898FA },
+    { 0xDBAC6C247D62A583, 0xDF45F746B74ABF39 }, { 0x894BC396CE5DA772, 0x6B8BBA8C328EB783 },
+    { 0xAB9EB47C81F5114F, 0x066EA92F3F326564 }, { 0xD686619BA27255A2, 0xC80A537B0EFEFEBD },
+    { 0x8613FD0145877585, 0xBD06742CE95F5F36 }, { 0xA798FC4196E952E7, 0x2C48113823B73704 },
+    { 0xD17F3B51FCA3A7A0, 0xF75A15862CA504C5 }, { 0x82EF85133DE648C4, 0x9A984D73DBE722FB },
+    { 0xA3AB66580D5FDAF5, 0xC13E60D0D2E0EBBA }, { 0xCC963FEE10B7D1B3, 0x318DF905079926A8 },
+    { 0xFFBBCFE994E5C61F, 0xFDF17746497F7052 }, { 0x9FD561F1FD0F9BD3, 0xFEB6EA8BEDEFA633 },
+    { 0xC7CABA6E7C5382C8, 0xFE64A52EE96B8FC0 }, { 0xF9BD690A1B68637B, 0x3DFDCE7AA3C673B0 },
+    { 0x9C1661A651213E2D, 0x06BEA10CA65C084E }, { 0xC31BFA0FE5698DB8, 0x486E494FCFF30A62 },
+    { 0xF3E2F893DEC3F126, 0x5A89DBA3C3EFCCFA }, { 0x986DDB5C6B3A76B7, 0xF89629465A75E01C },
+    { 0xBE89523386091465, 0xF6BBB397F1135823 }, { 0xEE2BA6C0678B597F, 0x746AA07DED582E2C },
+    { 0x94DB483840B717EF, 0xA8C2A44EB4571CDC }, { 0xBA121A4650E4DDEB, 0x92F34D62616CE413 },
+    { 0xE896A0D7E51E1566, 0x77B020BAF9C81D17 }, { 0x915E2486EF32CD60, 0x0ACE1474DC1D122E },
+    { 0xB5B5ADA8AAFF80B8, 0x0D819992132456BA }, { 0xE3231912D5BF60E6, 0x10E1FFF697ED6C69 },
+    { 0x8DF5EFABC5979C8F, 0xCA8D3FFA1EF463C1 }, { 0xB1736B96B6FD83B3, 0xBD308FF8A6B17CB2 },
+    { 0xDDD0467C64BCE4A0, 0xAC7CB3F6D05DDBDE }, { 0x8AA22C0DBEF60EE4, 0x6BCDF07A423AA96B },
+    { 0xAD4AB7112EB3929D, 0x86C16C98D2C953C6 }, { 0xD89D64D57A607744, 0xE871C7BF077BA8B7 },
+    { 0x87625F056C7C4A8B, 0x11471CD764AD4972 }, { 0xA93AF6C6C79B5D2D, 0xD598E40D3DD89BCF },
+    { 0xD389B47879823479, 0x4AFF1D108D4EC2C3 }, { 0x843610CB4BF160CB, 0xCEDF722A585139BA },
+    { 0xA54394FE1EEDB8FE, 0xC2974EB4EE658828 }, { 0xCE947A3DA6A9273E, 0x733D226229FEEA32 },
+    { 0x811CCC668829B887, 0x0806357D5A3F525F }, { 0xA163FF802A3426A8, 0xCA07C2DCB0CF26F7 },
+    { 0xC9BCFF6034C13052, 0xFC89B393DD02F0B5 }, { 0xFC2C3F3841F17C67, 0xBBAC2078D443ACE2 },
+    { 0x9D9BA7832936EDC0, 0xD54B944B84AA4C0D }, { 0xC5029163F384A931, 0x0A9E795E65D4DF11 },
+    { 0xF64335BCF065D37D, 0x4D4617B5FF4A16D5 }, { 0x99EA0196163FA42E, 0x504BCED1BF8E4E45 },
+    { 0xC06481FB9BCF8D39, 0xE45EC2862F71E1D6 }, { 0xF07DA27A82C37088, 0x5D767327BB4E5A4C },
+    { 0x964E858C91BA2655, 0x3A6A07F8D510F86F }, { 0xBBE226EFB628AFEA, 0x890489F70A55368B },
+    { 0xEADAB0ABA3B2DBE5, 0x2B45AC74CCEA842E }, { 0x92C8AE6B464FC96F, 0x3B0B8BC90012929D },
+    { 0xB77ADA0617E3BBCB, 0x09CE6EBB40173744 }, { 0xE55990879DDCAABD, 0xCC420A6A101D0515 },
+    { 0x8F57FA54C2A9EAB6, 0x9FA946824A12232D }, { 0xB32DF8E9F3546564, 0x47939822DC96ABF9 },
+    { 0xDFF9772470297EBD, 0x59787E2B93BC56F7 }, { 0x8BFBEA76C619EF36, 0x57EB4EDB3C55B65A },
+    { 0xAEFAE51477A06B03, 0xEDE622920B6B23F1 }, { 0xDAB99E59958885C4, 0xE95FAB368E45ECED },
+    { 0x88B402F7FD75539B, 0x11DBCB0218EBB414 }, { 0xAAE103B5FCD2A881, 0xD652BDC29F26A119 },
+    { 0xD59944A37C0752A2, 0x4BE76D3346F0495F }, { 0x857FCAE62D8493A5, 0x6F70A4400C562DDB },
+    { 0xA6DFBD9FB8E5B88E, 0xCB4CCD500F6BB952 }, { 0xD097AD07A71F26B2, 0x7E2000A41346A7A7 },
+    { 0x825ECC24C873782F, 0x8ED400668C0C28C8 }, { 0xA2F67F2DFA90563B, 0x728900802F0F32FA },
+    { 0xCBB41EF979346BCA, 0x4F2B40A03AD2FFB9 }, { 0xFEA126B7D78186BC, 0xE2F610C84987BFA8 },
+    { 0x9F24B832E6B0F436, 0x0DD9CA7D2DF4D7C9 }, { 0xC6EDE63FA05D3143, 0x91503D1C79720DBB },
+    { 0xF8A95FCF88747D94, 0x75A44C6397CE912A }, { 0x9B69DBE1B548CE7C, 0xC986AFBE3EE11ABA },
+    { 0xC24452DA229B021B, 0xFBE85BADCE996168 }, { 0xF2D56790AB41C2A2, 0xFAE27299423FB9C3 },
+    { 0x97C560BA6B0919A5, 0xDCCD879FC967D41A }, { 0xBDB6B8E905CB600F, 0x5400E987BBC1C920 },
+    { 0xED246723473E3813, 0x290123E9AAB23B68 }, { 0x9436C0760C86E30B, 0xF9A0B6720AAF6521 },
+    { 0xB94470938FA89BCE, 0xF808E40E8D5B3E69 }, { 0xE7958CB87392C2C2, 0xB60B1D1230B20E04 },
+    { 0x90BD77F3483BB9B9, 0xB1C6F22B5E6F48C2 }, { 0xB4ECD5F01A4AA828, 0x1E38AEB6360B1AF3 },
+    { 0xE2280B6C20DD5232, 0x25C6DA63C38DE1B0 }, { 0x8D590723948A535F, 0x579C487E5A38AD0E },
+    { 0xB0AF48EC79ACE837, 0x2D835A9DF0C6D851 }, { 0xDCDB1B2798182244, 0xF8E431456CF88E65 },
+    { 0x8A08F0F8BF0F156B, 0x1B8E9ECB641B58FF }, { 0xAC8B2D36EED2DAC5, 0xE272467E3D222F3F },
+    { 0xD7ADF884AA879177, 0x5B0ED81DCC6ABB0F }, { 0x86CCBB52EA94BAEA, 0x98E947129FC2B4E9 },
+    { 0xA87FEA27A539E9A5, 0x3F2398D747B36224 }, { 0xD29FE4B18E88640E, 0x8EEC7F0D19A03AAD },
+    { 0x83A3EEEEF9153E89, 0x1953CF68300424AC }, { 0xA48CEAAAB75A8E2B, 0x5FA8C3423C052DD7 },
+    { 0xCDB02555653131B6, 0x3792F412CB06794D }, { 0x808E17555F3EBF11, 0xE2BBD88BBEE40BD0 },
+    { 0xA0B19D2AB70E6ED6, 0x5B6ACEAEAE9D0EC4 }, { 0xC8DE047564D20A8B, 0xF245825A5A445275 },
+    { 0xFB158592BE068D2E, 0xEED6E2F0F0D56712 }, { 0x9CED737BB6C4183D, 0x55464DD69685606B },
+    { 0xC428D05AA4751E4C, 0xAA97E14C3C26B886 }, { 0xF53304714D9265DF, 0xD53DD99F4B3066A8 },
+    { 0x993FE2C6D07B7FAB, 0xE546A8038EFE4029 }, { 0xBF8FDB78849A5F96, 0xDE98520472BDD033 },
+    { 0xEF73D256A5C0F77C, 0x963E66858F6D4440 }, { 0x95A8637627989AAD, 0xDDE7001379A44AA8 },
+    { 0xBB127C53B17EC159, 0x5560C018580D5D52 }, { 0xE9D71B689DDE71AF, 0xAAB8F01E6E10B4A6 },
+    { 0x9226712162AB070D, 0xCAB3961304CA70E8 }, { 0xB6B00D69BB55C8D1, 0x3D607B97C5FD0D22 },
+    { 0xE45C10C42A2B3B05, 0x8CB89A7DB77C506A }, { 0x8EB98A7A9A5B04E3, 0x77F3608E92ADB242 },
+    { 0xB267ED1940F1C61C, 0x55F038B237591ED3 }, { 0xDF01E85F912E37A3, 0x6B6C46DEC52F6688 },
+    { 0x8B61313BBABCE2C6, 0x2323AC4B3B3DA015 }, { 0xAE397D8AA96C1B77, 0xABEC975E0A0D081A },
+    { 0xD9C7DCED53C72255, 0x96E7BD358C904A21 }, { 0x881CEA14545C7575, 0x7E50D64177DA2E54 },
+    { 0xAA242499697392D2, 0xDDE50BD1D5D0B9E9 }, { 0xD4AD2DBFC3D07787, 0x955E4EC64B44E864 },
+    { 0x84EC3C97DA624AB4, 0xBD5AF13BEF0B113E }, { 0xA6274BBDD0FADD61, 0xECB1AD8AEACDD58E },
+    { 0xCFB11EAD453994BA, 0x67DE18EDA5814AF2 }, { 0x81CEB32C4B43FCF4, 0x80EACF948770CED7 },
+    { 0xA2425FF75E14FC31, 0xA1258379A94D028D }, { 0xCAD2F7F5359A3B3E, 0x096EE45813A04330 },
+    { 0xFD87B5F28300CA0D, 0x8BCA9D6E188853FC }, { 0x9E74D1B791E07E48, 0x775EA264CF55347E },
+    { 0xC612062576589DDA, 0x95364AFE032A819E }, { 0xF79687AED3EEC551, 0x3A83DDBD83F52205 },
+    { 0x9ABE14CD44753B52, 0xC4926A9672793543 }, { 0xC16D9A0095928A27, 0x75B7053C0F178294 },
+    { 0xF1C90080BAF72CB1, 0x5324C68B12DD6339 }, { 0x971DA05074DA7BEE, 0xD3F6FC16EBCA5E04 },
+    { 0xBCE5086492111AEA, 0x88F4BB1CA6BCF585 }, { 0xEC1E4A7DB69561A5, 0x2B31E9E3D06C32E6 },
+    { 0x9392EE8E921D5D07, 0x3AFF322E62439FD0 }, { 0xB877AA3236A4B449, 0x09BEFEB9FAD487C3 },
+    { 0xE69594BEC44DE15B, 0x4C2EBE687989A9B4 }, { 0x901D7CF73AB0ACD9, 0x0F9D37014BF60A11 },
+    { 0xB424DC35095CD80F, 0x538484C19EF38C95 }, { 0xE12E13424BB40E13, 0x2865A5F206B06FBA },
+    { 0x8CBCCC096F5088CB, 0xF93F87B7442E45D4 }, { 0xAFEBFF0BCB24AAFE, 0xF78F69A51539D749 },
+    { 0xDBE6FECEBDEDD5BE, 0xB573440E5A884D1C }, { 0x89705F4136B4A597, 0x31680A88F8953031 },
+    { 0xABCC77118461CEFC, 0xFDC20D2B36BA7C3E }, { 0xD6BF94D5E57A42BC, 0x3D32907604691B4D },
+    { 0x8637BD05AF6C69B5, 0xA63F9A49C2C1B110 }, { 0xA7C5AC471B478423, 0x0FCF80DC33721D54 },
+    { 0xD1B71758E219652B, 0xD3C36113404EA4A9 }, { 0x83126E978D4FDF3B, 0x645A1CAC083126EA },
+    { 0xA3D70A3D70A3D70A, 0x3D70A3D70A3D70A4 }, { 0xCCCCCCCCCCCCCCCC, 0xCCCCCCCCCCCCCCCD },
+    { 0x8000000000000000, 0x0000000000000000 }, { 0xA000000000000000, 0x0000000000000000 },
+    { 0xC800000000000000, 0x0000000000000000 }, { 0xFA00000000000000, 0x0000000000000000 },
+    { 0x9C40000000000000, 0x0000000000000000 }, { 0xC350000000000000, 0x0000000000000000 },
+    { 0xF424000000000000, 0x0000000000000000 }, { 0x9896800000000000, 0x0000000000000000 },
+    { 0xBEBC200000000000, 0x0000000000000000 }, { 0xEE6B280000000000, 0x0000000000000000 },
+    { 0x9502F90000000000, 0x0000000000000000 }, { 0xBA43B74000000000, 0x0000000000000000 },
+    { 0xE8D4A51000000000, 0x0000000000000000 }, { 0x9184E72A00000000, 0x0000000000000000 },
+    { 0xB5E620F480000000, 0x0000000000000000 }, { 0xE35FA931A0000000, 0x0000000000000000 },
+    { 0x8E1BC9BF04000000, 0x0000000000000000 }, { 0xB1A2BC2EC5000000, 0x0000000000000000 },
+    { 0xDE0B6B3A76400000, 0x0000000000000000 }, { 0x8AC7230489E80000, 0x0000000000000000 },
+    { 0xAD78EBC5AC620000, 0x0000000000000000 }, { 0xD8D726B7177A8000, 0x0000000000000000 },
+    { 0x878678326EAC9000, 0x0000000000000000 }, { 0xA968163F0A57B400, 0x0000000000000000 },
+    { 0xD3C21BCECCEDA100, 0x0000000000000000 }, { 0x84595161401484A0, 0x0000000000000000 },
+    { 0xA56FA5B99019A5C8, 0x0000000000000000 }, { 0xCECB8F27F4200F3A, 0x0000000000000000 },
+    { 0x813F3978F8940984, 0x4000000000000000 }, { 0xA18F07D736B90BE5, 0x5000000000000000 },
+    { 0xC9F2C9CD04674EDE, 0xA400000000000000 }, { 0xFC6F7C4045812296, 0x4D00000000000000 },
+    { 0x9DC5ADA82B70B59D, 0xF020000000000000 }, { 0xC5371912364CE305, 0x6C28000000000000 },
+    { 0xF684DF56C3E01BC6, 0xC732000000000000 }, { 0x9A130B963A6C115C, 0x3C7F400000000000 },
+    { 0xC097CE7BC90715B3, 0x4B9F100000000000 }, { 0xF0BDC21ABB48DB20, 0x1E86D40000000000 },
+    { 0x96769950B50D88F4, 0x1314448000000000 }, { 0xBC143FA4E250EB31, 0x17D955A000000000 },
+    { 0xEB194F8E1AE525FD, 0x5DCFAB0800000000 }, { 0x92EFD1B8D0CF37BE, 0x5AA1CAE500000000 },
+    { 0xB7ABC627050305AD, 0xF14A3D9E40000000 }, { 0xE596B7B0C643C719, 0x6D9CCD05D0000000 },
+    { 0x8F7E32CE7BEA5C6F, 0xE4820023A2000000 }, { 0xB35DBF821AE4F38B, 0xDDA2802C8A800000 },
+    { 0xE0352F62A19E306E, 0xD50B2037AD200000 }, { 0x8C213D9DA502DE45, 0x4526F422CC340000 },
+    { 0xAF298D050E4395D6, 0x9670B12B7F410000 }, { 0xDAF3F04651D47B4C, 0x3C0CDD765F114000 },
+    { 0x88D8762BF324CD0F, 0xA5880A69FB6AC800 }, { 0xAB0E93B6EFEE0053, 0x8EEA0D047A457A00 },
+    { 0xD5D238A4ABE98068, 0x72A4904598D6D880 }, { 0x85A36366EB71F041, 0x47A6DA2B7F864750 },
+    { 0xA70C3C40A64E6C51, 0x999090B65F67D924 }, { 0xD0CF4B50CFE20765, 0xFFF4B4E3F741CF6D },
+    { 0x82818F1281ED449F, 0xBFF8F10E7A8921A4 }, { 0xA321F2D7226895C7, 0xAFF72D52192B6A0D },
+    { 0xCBEA6F8CEB02BB39, 0x9BF4F8A69F764490 }, { 0xFEE50B7025C36A08, 0x02F236D04753D5B4 },
+    { 0x9F4F2726179A2245, 0x01D762422C946590 }, { 0xC722F0EF9D80AAD6, 0x424D3AD2B7B97EF5 },
+    { 0xF8EBAD2B84E0D58B, 0xD2E0898765A7DEB2 }, { 0x9B934C3B330C8577, 0x63CC55F49F88EB2F },
+    { 0xC2781F49FFCFA6D5, 0x3CBF6B71C76B25FB }, { 0xF316271C7FC3908A, 0x8BEF464E3945EF7A },
+    { 0x97EDD871CFDA3A56, 0x97758BF0E3CBB5AC }, { 0xBDE94E8E43D0C8EC, 0x3D52EEED1CBEA317 },
+    { 0xED63A231D4C4FB27, 0x4CA7AAA863EE4BDD }, { 0x945E455F24FB1CF8, 0x8FE8CAA93E74EF6A },
+    { 0xB975D6B6EE39E436, 0xB3E2FD538E122B44 }, { 0xE7D34C64A9C85D44, 0x60DBBCA87196B616 },
+    { 0x90E40FBEEA1D3A4A, 0xBC8955E946FE31CD }, { 0xB51D13AEA4A488DD, 0x6BABAB6398BDBE41 },
+    { 0xE264589A4DCDAB14, 0xC696963C7EED2DD1 }, { 0x8D7EB76070A08AEC, 0xFC1E1DE5CF543CA2 },
+    { 0xB0DE65388CC8ADA8, 0x3B25A55F43294BCB }, { 0xDD15FE86AFFAD912, 0x49EF0EB713F39EBE },
+    { 0x8A2DBF142DFCC7AB, 0x6E3569326C784337 }, { 0xACB92ED9397BF996, 0x49C2C37F07965404 },
+    { 0xD7E77A8F87DAF7FB, 0xDC33745EC97BE906 }, { 0x86F0AC99B4E8DAFD, 0x69A028BB3DED71A3 },
+    { 0xA8ACD7C0222311BC, 0xC40832EA0D68CE0C }, { 0xD2D80DB02AABD62B, 0xF50A3FA490C30190 },
+    { 0x83C7088E1AAB65DB, 0x792667C6DA79E0FA }, { 0xA4B8CAB1A1563F52, 0x577001B891185938 },
+    { 0xCDE6FD5E09ABCF26, 0xED4C0226B55E6F86 }, { 0x80B05E5AC60B6178, 0x544F8158315B05B4 },
+    { 0xA0DC75F1778E39D6, 0x696361AE3DB1C721 }, { 0xC913936DD571C84C, 0x03BC3A19CD1E38E9 },
+    { 0xFB5878494ACE3A5F, 0x04AB48A04065C723 }, { 0x9D174B2DCEC0E47B, 0x62EB0D64283F9C76 },
+    { 0xC45D1DF942711D9A, 0x3BA5D0BD324F8394 }, { 0xF5746577930D6500, 0xCA8F44EC7EE36479 },
+    { 0x9968BF6ABBE85F20, 0x7E998B13CF4E1ECB }, { 0xBFC2EF456AE276E8, 0x9E3FEDD8C321A67E },
+    { 0xEFB3AB16C59B14A2, 0xC5CFE94EF3EA101E }, { 0x95D04AEE3B80ECE5, 0xBBA1F1D158724A12 },
+    { 0xBB445DA9CA61281F, 0x2A8A6E45AE8EDC97 }, { 0xEA1575143CF97226, 0xF52D09D71A3293BD },
+    { 0x924D692CA61BE758, 0x593C2626705F9C56 }, { 0xB6E0C377CFA2E12E, 0x6F8B2FB00C77836C },
+    { 0xE498F455C38B997A, 0x0B6DFB9C0F956447 }, { 0x8EDF98B59A373FEC, 0x4724BD4189BD5EAC },
+    { 0xB2977EE300C50FE7, 0x58EDEC91EC2CB657 }, { 0xDF3D5E9BC0F653E1, 0x2F2967B66737E3ED },
+    { 0x8B865B215899F46C, 0xBD79E0D20082EE74 }, { 0xAE67F1E9AEC07187, 0xECD8590680A3AA11 },
+    { 0xDA01EE641A708DE9, 0xE80E6F4820CC9495 }, { 0x884134FE908658B2, 0x3109058D147FDCDD },
+    { 0xAA51823E34A7EEDE, 0xBD4B46F0599FD415 }, { 0xD4E5E2CDC1D1EA96, 0x6C9E18AC7007C91A },
+    { 0x850FADC09923329E, 0x03E2CF6BC604DDB0 }, { 0xA6539930BF6BFF45, 0x84DB8346B786151C },
+    { 0xCFE87F7CEF46FF16, 0xE612641865679A63 }, { 0x81F14FAE158C5F6E, 0x4FCB7E8F3F60C07E },
+    { 0xA26DA3999AEF7749, 0xE3BE5E330F38F09D }, { 0xCB090C8001AB551C, 0x5CADF5BFD3072CC5 },
+    { 0xFDCB4FA002162A63, 0x73D9732FC7C8F7F6 }, { 0x9E9F11C4014DDA7E, 0x2867E7FDDCDD9AFA },
+    { 0xC646D63501A1511D, 0xB281E1FD541501B8 }, { 0xF7D88BC24209A565, 0x1F225A7CA91A4226 },
+    { 0x9AE757596946075F, 0x3375788DE9B06958 }, { 0xC1A12D2FC3978937, 0x0052D6B1641C83AE },
+    { 0xF209787BB47D6B84, 0xC0678C5DBD23A49A }, { 0x9745EB4D50CE6332, 0xF840B7BA963646E0 },
+    { 0xBD176620A501FBFF, 0xB650E5A93BC3D898 }, { 0xEC5D3FA8CE427AFF, 0xA3E51F138AB4CEBE },
+    { 0x93BA47C980E98CDF, 0xC66F336C36B10137 }, { 0xB8A8D9BBE123F017, 0xB80B0047445D4184 },
+    { 0xE6D3102AD96CEC1D, 0xA60DC059157491E5 }, { 0x9043EA1AC7E41392, 0x87C89837AD68DB2F },
+    { 0xB454E4A179DD1877, 0x29BABE4598C311FB }, { 0xE16A1DC9D8545E94, 0xF4296DD6FEF3D67A },
+    { 0x8CE2529E2734BB1D, 0x1899E4A65F58660C }, { 0xB01AE745B101E9E4, 0x5EC05DCFF72E7F8F },
+    { 0xDC21A1171D42645D, 0x76707543F4FA1F73 }, { 0x899504AE72497EBA, 0x6A06494A791C53A8 },
+    { 0xABFA45DA0EDBDE69, 0x0487DB9D17636892 }, { 0xD6F8D7509292D603, 0x45A9D2845D3C42B6 },
+    { 0x865B86925B9BC5C2, 0x0B8A2392BA45A9B2 }, { 0xA7F26836F282B732, 0x8E6CAC7768D7141E },
+    { 0xD1EF0244AF2364FF, 0x3207D795430CD926 }, { 0x8335616AED761F1F, 0x7F44E6BD49E807B8 },
+    { 0xA402B9C5A8D3A6E7, 0x5F16206C9C6209A6 }, { 0xCD036837130890A1, 0x36DBA887C37A8C0F },
+    { 0x802221226BE55A64, 0xC2494954DA2C9789 }, { 0xA02AA96B06DEB0FD, 0xF2DB9BAA10B7BD6C },
+    { 0xC83553C5C8965D3D, 0x6F92829494E5ACC7 }, { 0xFA42A8B73ABBF48C, 0xCB772339BA1F17F9 },
+    { 0x9C69A97284B578D7, 0xFF2A760414536EFB }, { 0xC38413CF25E2D70D, 0xFEF5138519684ABA },
+    { 0xF46518C2EF5B8CD1, 0x7EB258665FC25D69 }, { 0x98BF2F79D5993802, 0xEF2F773FFBD97A61 },
+    { 0xBEEEFB584AFF8603, 0xAAFB550FFACFD8FA }, { 0xEEAABA2E5DBF6784, 0x95BA2A53F983CF38 },
+    { 0x952AB45CFA97A0B2, 0xDD945A747BF26183 }, { 0xBA756174393D88DF, 0x94F971119AEEF9E4 },
+    { 0xE912B9D1478CEB17, 0x7A37CD5601AAB85D }, { 0x91ABB422CCB812EE, 0xAC62E055C10AB33A },
+    { 0xB616A12B7FE617AA, 0x577B986B314D6009 }, { 0xE39C49765FDF9D94, 0xED5A7E85FDA0B80B },
+    { 0x8E41ADE9FBEBC27D, 0x14588F13BE847307 }, { 0xB1D219647AE6B31C, 0x596EB2D8AE258FC8 },
+    { 0xDE469FBD99A05FE3, 0x6FCA5F8ED9AEF3BB }, { 0x8AEC23D680043BEE, 0x25DE7BB9480D5854 },
+    { 0xADA72CCC20054AE9, 0xAF561AA79A10AE6A }, { 0xD910F7FF28069DA4, 0x1B2BA1518094DA04 },
+    { 0x87AA9AFF79042286, 0x90FB44D2F05D0842 }, { 0xA99541BF57452B28, 0x353A1607AC744A53 },
+    { 0xD3FA922F2D1675F2, 0x42889B8997915CE8 }, { 0x847C9B5D7C2E09B7, 0x69956135FEBADA11 },
+    { 0xA59BC234DB398C25, 0x43FAB9837E699095 }, { 0xCF02B2C21207EF2E, 0x94F967E45E03F4BB },
+    { 0x8161AFB94B44F57D, 0x1D1BE0EEBAC278F5 }, { 0xA1BA1BA79E1632DC, 0x6462D92A69731732 },
+    { 0xCA28A291859BBF93, 0x7D7B8F7503CFDCFE }, { 0xFCB2CB35E702AF78, 0x5CDA735244C3D43E },
+    { 0x9DEFBF01B061ADAB, 0x3A0888136AFA64A7 }, { 0xC56BAEC21C7A1916, 0x088AAA1845B8FDD0 },
+    { 0xF6C69A72A3989F5B, 0x8AAD549E57273D45 }, { 0x9A3C2087A63F6399, 0x36AC54E2F678864B },
+    { 0xC0CB28A98FCF3C7F, 0x84576A1BB416A7DD }, { 0xF0FDF2D3F3C30B9F, 0x656D44A2A11C51D5 },
+    { 0x969EB7C47859E743, 0x9F644AE5A4B1B325 }, { 0xBC4665B596706114, 0x873D5D9F0DDE1FEE },
+    { 0xEB57FF22FC0C7959, 0xA90CB506D155A7EA }, { 0x9316FF75DD87CBD8, 0x09A7F12442D588F2 },
+    { 0xB7DCBF5354E9BECE, 0x0C11ED6D538AEB2F }, { 0xE5D3EF282A242E81, 0x8F1668C8A86DA5FA },
+    { 0x8FA475791A569D10, 0xF96E017D694487BC }, { 0xB38D92D760EC4455, 0x37C981DCC395A9AC },
+    { 0xE070F78D3927556A, 0x85BBE253F47B1417 }, { 0x8C469AB843B89562, 0x93956D7478CCEC8E },
+    { 0xAF58416654A6BABB, 0x387AC8D1970027B2 }, { 0xDB2E51BFE9D0696A, 0x06997B05FCC0319E },
+    { 0x88FCF317F22241E2, 0x441FECE3BDF81F03 }, { 0xAB3C2FDDEEAAD25A, 0xD527E81CAD7626C3 },
+    { 0xD60B3BD56A5586F1, 0x8A71E223D8D3B074 }, { 0x85C7056562757456, 0xF6872D5667844E49 },
+    { 0xA738C6BEBB12D16C, 0xB428F8AC016561DB }, { 0xD106F86E69D785C7, 0xE13336D701BEBA52 },
+    { 0x82A45B450226B39C, 0xECC0024661173473 }, { 0xA34D721642B06084, 0x27F002D7F95D0190 },
+    { 0xCC20CE9BD35C78A5, 0x31EC038DF7B441F4 }, { 0xFF290242C83396CE, 0x7E67047175A15271 },
+    { 0x9F79A169BD203E41, 0x0F0062C6E984D386 }, { 0xC75809C42C684DD1, 0x52C07B78A3E60868 },
+    { 0xF92E0C3537826145, 0xA7709A56CCDF8A82 }, { 0x9BBCC7A142B17CCB, 0x88A66076400BB691 },
+    { 0xC2ABF989935DDBFE, 0x6ACFF893D00EA435 }, { 0xF356F7EBF83552FE, 0x0583F6B8C4124D43 },
+    { 0x98165AF37B2153DE, 0xC3727A337A8B704A }, { 0xBE1BF1B059E9A8D6, 0x744F18C0592E4C5C },
+    { 0xEDA2EE1C7064130C, 0x1162DEF06F79DF73 }, { 0x9485D4D1C63E8BE7, 0x8ADDCB5645AC2BA8 },
+    { 0xB9A74A0637CE2EE1, 0x6D953E2BD7173692 }, { 0xE8111C87C5C1BA99, 0xC8FA8DB6CCDD0437 },
+    { 0x910AB1D4DB9914A0, 0x1D9C9892400A22A2 }, { 0xB54D5E4A127F59C8, 0x2503BEB6D00CAB4B },
+    { 0xE2A0B5DC971F303A, 0x2E44AE64840FD61D }, { 0x8DA471A9DE737E24, 0x5CEAECFED289E5D2 },
+    { 0xB10D8E1456105DAD, 0x7425A83E872C5F47 }, { 0xDD50F1996B947518, 0xD12F124E28F77719 },
+    { 0x8A5296FFE33CC92F, 0x82BD6B70D99AAA6F }, { 0xACE73CBFDC0BFB7B, 0x636CC64D1001550B },
+    { 0xD8210BEFD30EFA5A, 0x3C47F7E05401AA4E }, { 0x8714A775E3E95C78, 0x65ACFAEC34810A71 },
+    { 0xA8D9D1535CE3B396, 0x7F1839A741A14D0D }, { 0xD31045A8341CA07C, 0x1EDE48111209A050 },
+    { 0x83EA2B892091E44D, 0x934AED0AAB460432 }, { 0xA4E4B66B68B65D60, 0xF81DA84D5617853F },
+    { 0xCE1DE40642E3F4B9, 0x36251260AB9D668E }, { 0x80D2AE83E9CE78F3, 0xC1D72B7C6B426019 },
+    { 0xA1075A24E4421730, 0xB24CF65B8612F81F }, { 0xC94930AE1D529CFC, 0xDEE033F26797B627 },
+    { 0xFB9B7CD9A4A7443C, 0x169840EF017DA3B1 }, { 0x9D412E0806E88AA5, 0x8E1F289560EE864E },
+    { 0xC491798A08A2AD4E, 0xF1A6F2BAB92A27E2 }, { 0xF5B5D7EC8ACB58A2, 0xAE10AF696774B1DB },
+    { 0x9991A6F3D6BF1765, 0xACCA6DA1E0A8EF29 }, { 0xBFF610B0CC6EDD3F, 0x17FD090A58D32AF3 },
+    { 0xEFF394DCFF8A948E, 0xDDFC4B4CEF07F5B0 }, { 0x95F83D0A1FB69CD9, 0x4ABDAF101564F98E },
+    { 0xBB764C4CA7A4440F, 0x9D6D1AD41ABE37F1 }, { 0xEA53DF5FD18D5513, 0x84C86189216DC5ED },
+    { 0x92746B9BE2F8552C, 0x32FD3CF5B4E49BB4 }, { 0xB7118682DBB66A77, 0x3FBC8C33221DC2A1 },
+    { 0xE4D5E82392A40515, 0x0FABAF3FEAA5334A }, { 0x8F05B1163BA6832D, 0x29CB4D87F2A7400E },
+    { 0xB2C71D5BCA9023F8, 0x743E20E9EF511012 }, { 0xDF78E4B2BD342CF6, 0x914DA9246B255416 },
+    { 0x8BAB8EEFB6409C1A, 0x1AD089B6C2F7548E }, { 0xAE9672ABA3D0C320, 0xA184AC2473B529B1 },
+    { 0xDA3C0F568CC4F3E8, 0xC9E5D72D90A2741E }, { 0x8865899617FB1871, 0x7E2FA67C7A658892 },
+    { 0xAA7EEBFB9DF9DE8D, 0xDDBB901B98FEEAB7 }, { 0xD51EA6FA85785631, 0x552A74227F3EA565 },
+    { 0x8533285C936B35DE, 0xD53A88958F87275F }, { 0xA67FF273B8460356, 0x8A892ABAF368F137 },
+    { 0xD01FEF10A657842C, 0x2D2B7569B0432D85 }, { 0x8213F56A67F6B29B, 0x9C3B29620E29FC73 },
+    { 0xA298F2C501F45F42, 0x8349F3BA91B47B8F }, { 0xCB3F2F7642717713, 0x241C70A936219A73 },
+    { 0xFE0EFB53D30DD4D7, 0xED238CD383AA0110 }, { 0x9EC95D1463E8A506, 0xF4363804324A40AA },
+    { 0xC67BB4597CE2CE48, 0xB143C6053EDCD0D5 }, { 0xF81AA16FDC1B81DA, 0xDD94B7868E94050A },
+    { 0x9B10A4E5E9913128, 0xCA7CF2B4191C8326 }, { 0xC1D4CE1F63F57D72, 0xFD1C2F611F63A3F0 },
+    { 0xF24A01A73CF2DCCF, 0xBC633B39673C8CEC }, { 0x976E41088617CA01, 0xD5BE0503E085D813 },
+    { 0xBD49D14AA79DBC82, 0x4B2D8644D8A74E18 }, { 0xEC9C459D51852BA2, 0xDDF8E7D60ED1219E },
+    { 0x93E1AB8252F33B45, 0xCABB90E5C942B503 }, { 0xB8DA1662E7B00A17, 0x3D6A751F3B936243 },
+    { 0xE7109BFBA19C0C9D, 0x0CC512670A783AD4 }, { 0x906A617D450187E2, 0x27FB2B80668B24C5 },
+    { 0xB484F9DC9641E9DA, 0xB1F9F660802DEDF6 }, { 0xE1A63853BBD26451, 0x5E7873F8A0396973 },
+    { 0x8D07E33455637EB2, 0xDB0B487B6423E1E8 }, { 0xB049DC016ABC5E5F, 0x91CE1A9A3D2CDA62 },
+    { 0xDC5C5301C56B75F7, 0x7641A140CC7810FB }, { 0x89B9B3E11B6329BA, 0xA9E904C87FCB0A9D },
+    { 0xAC2820D9623BF429, 0x546345FA9FBDCD44 }, { 0xD732290FBACAF133, 0xA97C177947AD4095 },
+    { 0x867F59A9D4BED6C0, 0x49ED8EABCCCC485D }, { 0xA81F301449EE8C70, 0x5C68F256BFFF5A74 },
+    { 0xD226FC195C6A2F8C, 0x73832EEC6FFF3111 }, { 0x83585D8FD9C25DB7, 0xC831FD53C5FF7EAB },
+    { 0xA42E74F3D032F525, 0xBA3E7CA8B77F5E55 }, { 0xCD3A1230C43FB26F, 0x28CE1BD2E55F35EB },
+    { 0x80444B5E7AA7CF85, 0x7980D163CF5B81B3 }, { 0xA0555E361951C366, 0xD7E105BCC332621F },
+    { 0xC86AB5C39FA63440, 0x8DD9472BF3FEFAA7 }, { 0xFA856334878FC150, 0xB14F98F6F0FEB951 },
+    { 0x9C935E00D4B9D8D2, 0x6ED1BF9A569F33D3 }, { 0xC3B8358109E84F07, 0x0A862F80EC4700C8 },
+    { 0xF4A642E14C6262C8, 0xCD27BB612758C0FA }, { 0x98E7E9CCCFBD7DBD, 0x8038D51CB897789C },
+    { 0xBF21E44003ACDD2C, 0xE0470A63E6BD56C3 }, { 0xEEEA5D5004981478, 0x1858CCFCE06CAC74 },
+    { 0x95527A5202DF0CCB, 0x0F37801E0C43EBC8 }, { 0xBAA718E68396CFFD, 0xD30560258F54E6BA },
+    { 0xE950DF20247C83FD, 0x47C6B82EF32A2069 }, { 0x91D28B7416CDD27E, 0x4CDC331D57FA5441 },
+    { 0xB6472E511C81471D, 0xE0133FE4ADF8E952 }, { 0xE3D8F9E563A198E5, 0x58180FDDD97723A6 },
+    { 0x8E679C2F5E44FF8F, 0x570F09EAA7EA7648 }
+};
+
+static const double json_pow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* 64 x 64 -> 128 位乘法, 返回低 64 位 */
+static uint64_t json_umul128(uint64_t a, uint64_t b, uint64_t* hi) {
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 r = (unsigned __int128)a * b;
+    *hi = (uint64_t)(r >> 64);
+    return (uint64_t)r;
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return _umul128(a, b, hi);
+#else
+    uint64_t a0 = (uint32_t)a, a1 = a >> 32, b0 = (uint32_t)b, b1 = b >> 32;
+    uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+    uint64_t mid = (p00 >> 32) + (uint32_t)p01 + (uint32_t)p10;
+    *hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+    return (mid << 32) | (uint32_t)p00;
+#endif
+}
+
+static int json_clz64(uint64_t x) {
+    int n = 0;
+    assert(x != 0);
+#if defined(__GNUC__)
+    n = __builtin_clzll(x);
+#else
+    while (!(x & 0x8000000000000000ULL)) {
+        x <<= 1;
+        n++;
+    }
+#endif
+    return n;
+}
+
+/* Eisel-Lemire: 求 w * 10^q 最接近的 double, 无法确定舍入方向时返回 false, 交给 strtod() */
+static int json_eisel_lemire(uint64_t w, int q, int negative, double* d) {
+    const uint64_t* t = json_pow5_table[q - JSON_POW5_MIN_EXP];
+    uint64_t hi, mid, lo, h2, mantissa, bits;
+    int64_t exponent;
+    int lz, upperbit;
+    lz = json_clz64(w);
+    w <<= lz;
+    /* (hi, mid, lo) = w * t, 共 192 位 */
+    mid = json_umul128(w, t[0], &hi);
+    lo = json_umul128(w, t[1], &h2);
+    mid += h2;
+    if (mid < h2)
+        hi++;
+    /* t 不精确时误差不超过 lo 一个 w, 最多向 mid 进位/借位 1, mid 接近 0 或全 1 时放弃 */
+    if ((q < 0 || q > 55) && (mid <= 1 || mid >= UINT64_MAX - 1))
+        return false;
+    upperbit = (int)(hi >> 63);
+    mantissa = hi >> (upperbit + 9); /* 53 位尾数 + 1 个舍入位 */
+    lz += 1 ^ upperbit;
+    /* 恰好在两个 double 中间时向偶数舍入 */
+    if ((mantissa & 3) == 1 && (hi & ((1ULL << (upperbit + 9)) - 1)) == 0 && mid == 0 && lo == 0)
+        mantissa--;
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    if (mantissa >= (1ULL << 53)) {
+        mantissa = 1ULL << 52;
+        lz--;
+    }
+    mantissa &= ~(1ULL << 52);
+    /* floor(q * log2(10)) + 1023 + 64 - lz */
+    exponent = ((((int64_t)152170 + 65536) * q) >> 16) + 1024 + 63 - lz;
+    if (exponent < 1 || exponent > 2046)
+        return false; /* 次正规数或溢出 */
+    bits = mantissa | ((uint64_t)exponent << 52) | ((uint64_t)negative << 63);
+    memcpy(d, &bits, sizeof(bits));
+    return true;
+}
+
+/* mantissa * 10^exponent, mantissa 不超过 19 位; 上溢时为 +-HUGE_VAL, 无法快速确定时返回 false */
+static int json_decimal_to_double(uint64_t mantissa, int exponent, int negative, double* d) {
+    if (mantissa == 0) {
+        *d = negative ? -0.0 : 0.0;
+        return true;
+    }
+#if !defined(FLT_EVAL_METHOD) || FLT_EVAL_METHOD == 0
+    /* Clinger 快速路径: 尾数和 10^|exponent| 都能用 double 精确表示时, 一次乘除即为正确舍入 */
+    if (exponent >= -22 && exponent <= 22 && mantissa <= (1ULL << 53)) {
+        double v = (double)mantissa;
+        v = exponent < 0 ? v / json_pow10[-exponent] : v * json_pow10[exponent];
+        *d = negative ? -v : v;
+        return true;
+    }
+#endif
+    if (exponent < JSON_POW5_MIN_EXP) { /* < 10^19 * 10^-343, 必然下溢为 0 */
+        *d = negative ? -0.0 : 0.0;
+        return true;
+    }
+    if (exponent > JSON_POW5_MAX_EXP) {
+        *d = negative ? -HUGE_VAL : HUGE_VAL;
+        return true;
+    }
+    return json_eisel_lemire(mantissa, exponent, negative, d);
+}
+
+/* 一次扫描同时校验语法并累积十进制尾数/指数, 多数情况下无需 strtod() */
 static int json_parse_number(json_context* context, json_value* value) {
-    const char* p;
+    const char* p, *end;
+    char buffer[64], *str;
+    size_t len;
+    uint64_t mantissa = 0;
+    int negative = false, digits = 0, exponent = 0, integer = true;
     p = context->json;
+    end = context->end;
     /* 负号 ... */
-    if (*p == '-') p++;
+    if (PEEK(p, end) == '-') {
+        negative = true;
+        p++;
+    }
     /* 整数 ... */
-    if (*p == '0') p++;
+    if (PEEK(p, end) == '0') p++;
     else {
-        if(!ISDIGIT1TO9(*p)) return JSON_PARSE_INVALID_VALUE;
-        while(ISDIGIT(*p)) p++;
+        if(!ISDIGIT1TO9(PEEK(p, end))) return JSON_PARSE_INVALID_VALUE;
+        do {
+            mantissa = mantissa * 10 + (*p++ - '0');
+            digits++;
+        } while (ISDIGIT(PEEK(p, end)));
     }
     /* 小数 ... */
-    if (*p == '.') {
+    if (PEEK(p, end) == '.') {
         p++;
-        if (!ISDIGIT(*p)) return JSON_PARSE_INVALID_VALUE;
-        while (ISDIGIT(*p)) p++;
+        integer = false;
+        if (!ISDIGIT(PEEK(p, end))) return JSON_PARSE_INVALID_VALUE;
+        do {
+            /* 前导零不计入有效数字 */
+            if (mantissa != 0 || *p != '0') {
+                mantissa = mantissa * 10 + (*p - '0');
+                digits++;
+            }
+            exponent--;
+            p++;
+        } while (ISDIGIT(PEEK(p, end)));
     }
     /* 指数 ... */
-    if (*p == 'e' || *p == 'E') {
+    if (PEEK(p, end) == 'e' || PEEK(p, end) == 'E') {
+        int e = 0, esign = 1;
         p++;
-        if (*p == '+' || *p == '-') p++;
-        if (!ISDIGIT(*p)) return JSON_PARSE_INVALID_VALUE;
-        while (ISDIGIT(*p)) p++;
+        integer = false;
+        if (PEEK(p, end) == '+' || PEEK(p, end) == '-') {
+            if (*p == '-')
+                esign = -1;
+            p++;
+        }
+        if (!ISDIGIT(PEEK(p, end))) return JSON_PARSE_INVALID_VALUE;
+        do {
+            if (e < 100000) /* 足以判定上溢/下溢, 避免 int 溢出 */
+                e = e * 10 + (*p - '0');
+            p++;
+        } while (ISDIGIT(PEEK(p, end)));
+        exponent += esign * e;
+    }
+
+    /* 整数: -0 仍保存为 double 以保留符号 */
+    if (integer && digits <= 19 && (mantissa != 0 || !negative) && mantissa <= (uint64_t)INT64_MAX + negative) {
+        value->i64 = negative ? (int64_t)(0 - mantissa) : (int64_t)mantissa;
+        value->type = JSON_NUMBER;
+        value->flags = JSON_FLAG_INT64;
+        context->json = p;
+        return JSON_PARSE_OK;
     }
 
+    /* 有效数字超过 19 位时 mantissa 已溢出, 只能走 strtod() */
+    if (digits <= 19 && json_decimal_to_double(mantissa, exponent, negative, &value->num)) {
+        if (value->num == HUGE_VAL || value->num == -HUGE_VAL)
+            return JSON_PARSE_NUMBER_TOO_BIG;
+        goto done;
+    }
+
+    /* 输入不一定以 '\0' 结尾, strtod() 可能读过 end, 先复制一份 */
+    len = p - context->json;
+    str = len < sizeof(buffer) ? buffer : (char*)json_context_push(context, len + 1);
+    memcpy(str, context->json, len);
+    str[len] = '\0';
     errno = 0;
-    value->num = strtod(context->json, NULL);
+    value->num = strtod(str, NULL);
+    if (str != buffer)
+        json_context_pop(context, len + 1);
     if (errno == ERANGE && (value->num == HUGE_VAL || value->num == -HUGE_VAL))
         return JSON_PARSE_NUMBER_TOO_BIG;
+done:
     value->type = JSON_NUMBER;
+    value->flags = 0;
     context->json = p;
     return JSON_PARSE_OK;
 }
 
-static const char* json_parse_hex4(const char* p,  unsigned* u) {
+static const char* json_parse_hex4(const char* p, const char* end, unsigned* u) {
     *u = 0;
     for (int i = 0; i < 4; i++) {
-        char ch = *p++;
+        char ch = PEEK(p, end);
+        p++;
         *u <<= 4;
         if      (ch >= '0' && ch <= '9') *u |= ch - '0';
         else if (ch >= 'a' && ch <= 'f') *u |= ch - ('a' - 10);
@@ -130,83 +863,110 @@ static const char* json_parse_hex4(const char* p,  unsigned* u) {
     /* 也可直接使用 strtol() 函数 但是需要检测特使情况*/
 }
 
-static void json_encode_utf8(json_context* c, unsigned u) {
+/* 写入 p, 返回写入后的位置 (最多 4 字节) */
+static char* json_encode_utf8(char* p, unsigned u) {
     if      (u <= 0x7F){
-        PUTC(c, u & 0xFF);
+        *p++ = u & 0xFF;
     }
     else if (u <= 0x7FF) {
-        PUTC(c, 0xC0 | ((u >> 6) & 0XFF));
-        PUTC(c, 0x80 | ( u       & 0x3F));
+        *p++ = 0xC0 | ((u >> 6) & 0XFF);
+        *p++ = 0x80 | ( u       & 0x3F);
     }
     else if (u <= 0xFFFF) {
-        PUTC(c, 0xE0 | ((u >> 12) & 0xFF));
-        PUTC(c, 0x80 | ((u >> 6 ) & 0x3F));
-        PUTC(c, 0x80 | ( u        & 0x3F));
+        *p++ = 0xE0 | ((u >> 12) & 0xFF);
+        *p++ = 0x80 | ((u >> 6 ) & 0x3F);
+        *p++ = 0x80 | ( u        & 0x3F);
     }
     else {
         assert(u <= 0x10FFFF);
-        PUTC(c, 0xF0 | ((u >> 18) & 0xFF));
-        PUTC(c, 0x80 | ((u >> 12) & 0x3F));
-        PUTC(c, 0x80 | ((u >>  6) & 0x3F));
-        PUTC(c, 0x80 | ( u        & 0x3F));
+        *p++ = 0xF0 | ((u >> 18) & 0xFF);
+        *p++ = 0x80 | ((u >> 12) & 0x3F);
+        *p++ = 0x80 | ((u >>  6) & 0x3F);
+        *p++ = 0x80 | ( u        & 0x3F);
     }
+    return p;
 }
 
 #define STRING_ERROR(c, ret)   do { c->top = head; return ret; } while(0)
+/* in-situ 时写回输入缓冲区 (d), 否则压入 c->stack */
+#define STRING_PUTC(c, ch)     do { if (d) *d++ = (ch); else PUTC(c, ch); } while(0)
+#define STRING_PUTS(c, s, n)   do { if (d) { memmove(d, s, n); d += (n); } else PUTS(c, s, n); } while(0)
 
 /* 解析 JSON 字符串,把结果写入 str 和len */
 /* str 指向 c->stack 中的元素, 需要在 c->stack */
+/* in-situ 模式下 str 直接指向输入缓冲区, 转义后的结果不会比原文长, 故可原地改写 */
 static int json_parse_string_raw(json_context* context, char** str, size_t* len) {
     size_t head = context->top;
-    const char* p;
+    const char* p, *end;
+    char* d, *start;
     unsigned u, u2;
     EXPECT(context, '\"');
     p = context->json;
+    end = context->end;
+    d = start = context->insitu ? (char*)p : NULL;
 
     while(1) {
-        char ch = *p++;
+        char ch;
+        /* 整段复制不需要转义的字符 */
+        const char* q = json_scan_string(p, end);
+        if (q != p) {
+            if (d != p)
+                STRING_PUTS(context, p, q - p);
+            else
+                d += q - p; /* in-situ 且尚未遇到转义, 原地不动 */
+            p = q;
+        }
+        if (p == end)
+            STRING_ERROR(context, JSON_PARSE_MISS_QUOTATION_MARK);
+        ch = *p++;
         switch(ch) {
             case '\"':
-                *len = context->top - head;
-                *str = (const char*)json_context_pop(context, *len);
+                if (d) {
+                    *len = d - start;
+                    *str = start;
+                    *d = '\0'; /* 覆盖结尾的引号或之前的位置 */
+                }
+                else {
+                    *len = context->top - head;
+                    *str = (char*)json_context_pop(context, *len);
+                }
                 context->json = p;
                 return JSON_PARSE_OK;
             case '\\':
-                switch(*p++) {
-                    case '\"': PUTC(context, '\"'); break;
-                    case '\\': PUTC(context, '\\'); break;
-                    case '/':  PUTC(context, '/' ); break;
-                    case 'b':  PUTC(context, '\b'); break;
-                    case 'f':  PUTC(context, '\f'); break;
-                    case 'n':  PUTC(context, '\n'); break;
-                    case 'r':  PUTC(context, '\r'); break;
-                    case 't':  PUTC(context, '\t'); break;
+                switch(p < end ? *p++ : '\0') {
+                    case '\"': STRING_PUTC(context, '\"'); break;
+                    case '\\': STRING_PUTC(context, '\\'); break;
+                    case '/':  STRING_PUTC(context, '/' ); break;
+                    case 'b':  STRING_PUTC(context, '\b'); break;
+                    case 'f':  STRING_PUTC(context, '\f'); break;
+                    case 'n':  STRING_PUTC(context, '\n'); break;
+                    case 'r':  STRING_PUTC(context, '\r'); break;
+                    case 't':  STRING_PUTC(context, '\t'); break;
                     case 'u':  
-                        if (!(p = json_parse_hex4(p, &u)))
+                        if (!(p = json_parse_hex4(p, end, &u)))
                             STRING_ERROR(context, JSON_PARSE_INVALID_UNICODE_HEX);
                         if (u >= 0xD800 && u <= 0xDBFF) { /* surrogate pair */
-                            if (*p++ != '\\')
-                                STRING_ERROR(context, JSON_PARSE_INVALID_UNICODE_SURROGATE);
-                            if (*p++ != 'u')
+                            if (PEEK(p, end) != '\\' || PEEK(p + 1, end) != 'u')
                                 STRING_ERROR(context, JSON_PARSE_INVALID_UNICODE_SURROGATE);
-                            if (!(p = json_parse_hex4(p, &u2)))
+                            p += 2;
+                            if (!(p = json_parse_hex4(p, end, &u2)))
                                 STRING_ERROR(context, JSON_PARSE_INVALID_UNICODE_HEX);
                             if (u2 < 0xDC00 || u2 > 0xDFFF)
                                 STRING_ERROR(context, JSON_PARSE_INVALID_UNICODE_SURROGATE);
                             u = (((u - 0xD800) << 10) | (u2 - 0xDC00)) + 0x10000;
                         }
-                        json_encode_utf8(context, u);
+                        {
+                            char buffer[4];
+                            STRING_PUTS(context, buffer, json_encode_utf8(buffer, u) - buffer);
+                        }
                         break;
                     default:
                         STRING_ERROR(context, JSON_PARSE_INVALID_STRING_ESCAPE);
                 }
                 break;
-            case '\0':
-                STRING_ERROR(context, JSON_PARSE_MISS_QUOTATION_MARK);
             default:
-                if((unsigned char) ch < 0x20) 
-                    STRING_ERROR(context, JSON_PARSE_INVALID_STRING_CHAR);
-                PUTC(context, ch);
+                assert((unsigned char)ch < 0x20);
+                STRING_ERROR(context, JSON_PARSE_INVALID_STRING_CHAR);
         }
     }
 }
@@ -215,20 +975,241 @@ static int json_parse_string(json_context* context, json_value* value) {
     int ret;
     char* str;
     size_t len;
-    if ((ret = json_parse_string_raw(context, &str, &len)) == JSON_PARSE_OK) 
-        json_set_string(value, str, len);
+    if ((ret = json_parse_string_raw(context, &str, &len)) == JSON_PARSE_OK) {
+        if (context->insitu)
+            value->str = str;
+        else {
+            value->str = (char*)json_context_alloc(context, len + 1);
+            if (len)
+                memcpy(value->str, str, len);
+            value->str[len] = '\0';
+        }
+        value->len = len;
+        value->type = JSON_STRING;
+    }
     return ret;
 }
 
+/* FNV-1a */
+static uint32_t json_hash_key(const char* key, size_t klen) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < klen; i++) {
+        h ^= (unsigned char)key[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+/* 开放寻址表的槽数: 不小于 2n 的 2 的幂, 负载因子不超过 0.5 */
+static size_t json_object_index_capacity(size_t n) {
+    size_t cap = 1;
+    while (cap < n * 2)
+        cap <<= 1;
+    return cap;
+}
+
+/* 索引紧跟在 n 个成员之后, 槽中存成员下标 + 1, 0 为空槽 */
+static size_t json_object_index_size(size_t n) {
+    return n >= JSON_OBJECT_INDEX_THRESHOLD && n < UINT32_MAX ? json_object_index_capacity(n) * sizeof(uint32_t) : 0;
+}
+
+static void json_object_build_index(json_member* mem, size_t n) {
+    uint32_t* table = (uint32_t*)(mem + n);
+    size_t mask = json_object_index_capacity(n) - 1;
+    memset(table, 0, (mask + 1) * sizeof(uint32_t));
+    /* 按顺序线性探测插入, 重复的键排在前一个之后, 查找时先命中第一个 */
+    for (size_t i = 0; i < n; i++) {
+        size_t slot = json_hash_key(mem[i].key, mem[i].keylen) & mask;
+        while (table[slot])
+            slot = (slot + 1) & mask;
+        table[slot] = (uint32_t)(i + 1);
+    }
+}
+
+/* 用栈上的 size 个成员生成对象, 成员够多时附带索引 */
+static void json_context_pop_object(json_context* context, json_value* value, size_t size) {
+    size_t size_tmp = sizeof(json_member) * size, index_size = json_object_index_size(size);
+    value->type = JSON_OBJECT;
+    value->msize = size;
+    value->mem = (json_member*)json_context_alloc(context, size_tmp + index_size);
+    memcpy(value->mem, json_context_pop(context, size_tmp), size_tmp);
+    value->flags = 0;
+    if (index_size) {
+        json_object_build_index(value->mem, size);
+        value->flags = JSON_FLAG_INDEXED;
+    }
+}
+
+/* 只校验字符串, 不解码也不入栈; 错误码与 json_parse_string_raw() 相同 */
+static int json_skip_string(json_context* context) {
+    const char* p, *end;
+    unsigned u, u2;
+    EXPECT(context, '\"');
+    p = context->json;
+    end = context->end;
+    while (1) {
+        p = json_scan_string(p, end);
+        if (p == end)
+            return JSON_PARSE_MISS_QUOTATION_MARK;
+        switch (*p++) {
+            case '\"':
+                context->json = p;
+                return JSON_PARSE_OK;
+            case '\\':
+                switch (p < end ? *p++ : '\0') {
+                    case '\"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+                        break;
+                    case 'u':
+                        if (!(p = json_parse_hex4(p, end, &u)))
+                            return JSON_PARSE_INVALID_UNICODE_HEX;
+                        if (u >= 0xD800 && u <= 0xDBFF) {
+                            if (PEEK(p, end) != '\\' || PEEK(p + 1, end) != 'u')
+                                return JSON_PARSE_INVALID_UNICODE_SURROGATE;
+                            if (!(p = json_parse_hex4(p + 2, end, &u2)))
+                                return JSON_PARSE_INVALID_UNICODE_HEX;
+                            if (u2 < 0xDC00 || u2 > 0xDFFF)
+                                return JSON_PARSE_INVALID_UNICODE_SURROGATE;
+                        }
+                        break;
+                    default:
+                        return JSON_PARSE_INVALID_STRING_ESCAPE;
+                }
+                break;
+            default:
+                return JSON_PARSE_INVALID_STRING_CHAR;
+        }
+    }
+}
+
+/* 按 json_parse_value() 的文法校验并跳过一个值, 不分配节点/键/字符串, 错误码相同 */
+static int json_skip_value(json_context* context) {
+    json_value v; /* 标量不分配内存, 临时存放即可 */
+    int ret;
+    switch (PEEK(context->json, context->end)) {
+        case 'n':  return json_parse_literal(context, &v, "null", JSON_NULL);
+        case 'f':  return json_parse_literal(context, &v, "false", JSON_FALSE);
+        case 't':  return json_parse_literal(context, &v, "true", JSON_TRUE);
+        default:   return json_parse_number(context, &v);
+        case '"':  return json_skip_string(context);
+        case '\0': return JSON_PARSE_EXPECT_VALUE;
+        case '[':
+            context->json++;
+            json_parse_whitespace(context);
+            if (PEEK(context->json, context->end) == ']') {
+                context->json++;
+                return JSON_PARSE_OK;
+            }
+            while (1) {
+                if ((ret = json_skip_value(context)) != JSON_PARSE_OK)
+                    return ret;
+                json_parse_whitespace(context);
+                if (PEEK(context->json, context->end) == ',') {
+                    context->json++;
+                    json_parse_whitespace(context);
+                }
+                else if (PEEK(context->json, context->end) == ']') {
+                    context->json++;
+                    return JSON_PARSE_OK;
+                }
+                else
+                    return JSON_PARSE_MISS_COMMA_OR_SQUARE_BRACKET;
+            }
+        case '{':
+            context->json++;
+            json_parse_whitespace(context);
+            if (PEEK(context->json, context->end) == '}') {
+                context->json++;
+                return JSON_PARSE_OK;
+            }
+            while (1) {
+                if (PEEK(context->json, context->end) != '"')
+                    return JSON_PARSE_MISS_KEY;
+                if ((ret = json_skip_string(context)) != JSON_PARSE_OK)
+                    return ret;
+                json_parse_whitespace(context);
+                if (PEEK(context->json, context->end) != ':')
+                    return JSON_PARSE_MISS_COLON;
+                context->json++;
+                json_parse_whitespace(context);
+                if ((ret = json_skip_value(context)) != JSON_PARSE_OK)
+                    return ret;
+                json_parse_whitespace(context);
+                if (PEEK(context->json, context->end) == ',') {
+                    context->json++;
+                    json_parse_whitespace(context);
+                }
+                else if (PEEK(context->json, context->end) == '}') {
+                    context->json++;
+                    return JSON_PARSE_OK;
+                }
+                else
+                    return JSON_PARSE_MISS_COMMA_OR_CURLY_BRACKET;
+            }
+    }
+}
+
+#define JSON_PROJECT_SKIP 0 /* 不在任何路径上, 校验后跳过 */
+#define JSON_PROJECT_PATH 1 /* 在路径中途, 继续投影其子节点 */
+#define JSON_PROJECT_ALL  2 /* 路径的终点或其下, 完整构建 */
+
+/* 容器的子节点 (对象成员 key 或数组下标 index) 是否需要构建 */
+static int json_project_enter(json_context* context, const char* key, size_t klen, size_t index) {
+    struct json_projection* proj = context->projection;
+    int keep = JSON_PROJECT_SKIP;
+    if (proj == NULL)
+        return JSON_PROJECT_ALL;
+    for (size_t i = 0; i < proj->count; i++) {
+        const json_pointer_token* t;
+        if (proj->matched[i] != proj->depth)
+            continue;
+        t = &proj->paths[i]->tokens[proj->depth];
+        /* 数组中 "*" 匹配所有元素 */
+        if (index == JSON_KEY_NOT_EXIST ?
+            t->klen == klen && (klen == 0 || memcmp(t->key, key, klen) == 0) :
+            t->index == index || (t->klen == 1 && t->key[0] == '*')) {
+            proj->matched[i]++;
+            keep |= proj->paths[i]->count == proj->depth + 1 ? JSON_PROJECT_ALL : JSON_PROJECT_PATH;
+        }
+    }
+    return keep;
+}
+
 static int json_parse_value(json_context* context, json_value* value); /* 前向声明 */
 
+/* 按 json_project_enter() 的结果解析子节点; 路径中途的标量不构建, keep 改为 JSON_PROJECT_SKIP */
+static int json_project_value(json_context* context, json_value* value, int* keep) {
+    struct json_projection* proj = context->projection;
+    char ch = PEEK(context->json, context->end);
+    int ret;
+    if (proj == NULL)
+        return json_parse_value(context, value);
+    if (*keep & JSON_PROJECT_ALL) {
+        context->projection = NULL;
+        ret = json_parse_value(context, value);
+        context->projection = proj;
+    }
+    else if (*keep == JSON_PROJECT_PATH && (ch == '{' || ch == '[')) {
+        proj->depth++;
+        ret = json_parse_value(context, value);
+        proj->depth--;
+    }
+    else {
+        *keep = JSON_PROJECT_SKIP;
+        ret = json_skip_value(context);
+    }
+    for (size_t i = 0; i < proj->count; i++)
+        if (proj->matched[i] == proj->depth + 1)
+            proj->matched[i]--;
+    return ret;
+}
+
 static int json_parse_array(json_context* context, json_value* value) {
     size_t size = 0;
     int ret;
 
     EXPECT(context, '[');
     json_parse_whitespace(context);
-    if(*context->json == ']') {
+    if(PEEK(context->json, context->end) == ']') {
         context->json++;
         value->type = JSON_ARRAY;
         value->size = 0;
@@ -241,22 +1222,24 @@ static int json_parse_array(json_context* context, json_value* value) {
          栈满时会 realloc() 扩容, 最初 ele 失效 成为悬挂指针 
          使用 C++ STL 时同样要注意 迭代器(iterator) 在修改容器内容后可能会失效*/
         json_value ele;
+        int keep = json_project_enter(context, NULL, 0, size);
         json_init(&ele);
-        if ((ret = json_parse_value(context, &ele)) != JSON_PARSE_OK)
+        /* 投影时跳过的元素留作 null, 保持下标不变 */
+        if ((ret = json_project_value(context, &ele, &keep)) != JSON_PARSE_OK)
             break;
         memcpy(json_context_push(context, sizeof(json_value)), &ele, sizeof(json_value));
         size++;
         json_parse_whitespace(context);
-        if (*context->json ==',') {
+        if (PEEK(context->json, context->end) ==',') {
             context->json++;
             json_parse_whitespace(context);
         }
-        else if(*context->json ==']') {
+        else if(PEEK(context->json, context->end) ==']') {
             context->json++;
             value->type = JSON_ARRAY;
             value->size = size;
             size *= sizeof(json_value);
-            value->ele = (json_value*)malloc(size);
+            value->ele = (json_value*)json_context_alloc(context, size);
             memcpy(value->ele, json_context_pop(context, size), size);
             return JSON_PARSE_OK;
         }
@@ -267,7 +1250,7 @@ static int json_parse_array(json_context* context, json_value* value) {
     }
     /* Pop and free values on the stack */
     for (size_t i = 0; i < size; i++)
-        json_free((json_value*)json_context_pop(context, sizeof(json_value)));
+        json_context_free_value(context, (json_value*)json_context_pop(context, sizeof(json_value)));
     return ret;
 }
 
@@ -277,54 +1260,63 @@ static int json_parse_object(json_context* context, json_value* value) {
     int ret;
     EXPECT(context, '{');
     json_parse_whitespace(context);
-    if (*context->json == '}') {
+    if (PEEK(context->json, context->end) == '}') {
         context->json++;
         value->type = JSON_OBJECT;
         value->mem = 0;
         value->msize = 0;
+        value->flags = 0;
         return JSON_PARSE_OK;
     }
     mem.key = NULL;
     size = 0;
     while(1) {
         char* str;
+        int keep;
         json_init(&mem.value);
-        if (*context->json != '"') {
+        if (PEEK(context->json, context->end) != '"') {
             ret = JSON_PARSE_MISS_KEY;
             break;
         }
         if ((ret = json_parse_string_raw(context, &str, &mem.keylen)) != JSON_PARSE_OK)
             break;
-        mem.key = (char*) malloc(mem.keylen + 1);
-        memcpy(mem.key, str, mem.keylen);
-        mem.key[mem.keylen] = '\0';
+        if ((keep = json_project_enter(context, str, mem.keylen, JSON_KEY_NOT_EXIST)) == JSON_PROJECT_SKIP)
+            mem.key = NULL;
+        else if (context->insitu)
+            mem.key = str;
+        else {
+            mem.key = (char*) json_context_alloc(context, mem.keylen + 1);
+            if (mem.keylen)
+                memcpy(mem.key, str, mem.keylen);
+            mem.key[mem.keylen] = '\0';
+        }
         /* parse ws colon ws */
         json_parse_whitespace(context);
-        if(*context->json != ':') {
+        if(PEEK(context->json, context->end) != ':') {
             ret = JSON_PARSE_MISS_COLON;
             break;
         }
         context->json++;
         json_parse_whitespace(context);
         /* parse value */
-        if ((ret = json_parse_value(context, &mem.value)) != JSON_PARSE_OK)
+        if ((ret = json_project_value(context, &mem.value, &keep)) != JSON_PARSE_OK)
             break;
-        memcpy(json_context_push(context, sizeof(json_member)), &mem, sizeof(json_member));
-        size++;
+        if (keep != JSON_PROJECT_SKIP) {
+            memcpy(json_context_push(context, sizeof(json_member)), &mem, sizeof(json_member));
+            size++;
+        }
+        else if (context->arena == NULL && !context->insitu)
+            free(mem.key);
         mem.key = NULL; /* ownership is transferred to member on stack */
         /* todo parse ws [comma | right-curly-brace] ws */
         json_parse_whitespace(context);
-        if (*context->json == ',') {
+        if (PEEK(context->json, context->end) == ',') {
             context->json++;
             json_parse_whitespace(context);
         }
-        else if (*context->json == '}') {
+        else if (PEEK(context->json, context->end) == '}') {
             context->json++;
-            value->type = JSON_OBJECT;
-            value->msize = size;
-            size_t size_tmp = sizeof(json_member) * size;
-            value->mem = (json_member*)malloc(size_tmp);
-            memcpy(value->mem, json_context_pop(context, size_tmp), size_tmp);
+            json_context_pop_object(context, value, size);
             return JSON_PARSE_OK;
         }
         else {
@@ -333,16 +1325,306 @@ static int json_parse_object(json_context* context, json_value* value) {
         }
     }
     /* todo Pop and free members on the stack */
-    free(mem.key);
+    if (context->arena == NULL)
+        free(mem.key);
     for (int i = 0; i < size; i++) {
         json_member* m = (json_member*)json_context_pop(context, sizeof(json_member));
-        free(m->key);
-        json_free(&m->value);
+        if (context->arena == NULL)
+            free(m->key);
+        json_context_free_value(context, &m->value);
     }
     value->type = JSON_NULL;
     return ret;
 }
 
+/* Grisu2 (Florian Loitsch), 输出能还原为同一 double 的最短 (绝大多数情况下) 十进制数字 */
+typedef struct {
+    uint64_t f;
+    int e;
+} json_diyfp;
+
+/* 10^k 归一化后的 64 位尾数和二进制指数, k = -348, -340, ..., 340 */
+static const struct { uint64_t f; int e; } json_cached_powers[] = {
+    { 0xFA8FD5A0081C0288, -1220 }, { 0xBAAEE17FA23EBF76, -1193 }, { 0x8B16FB203055AC76, -1166 },
+    { 0xCF42894A5DCE35EA, -1140 }, { 0x9A6BB0AA55653B2D, -1113 }, { 0xE61ACF033D1A45DF, -1087 },
+    { 0xAB70FE17C79AC6CA, -1060 }, { 0xFF77B1FCBEBCDC4F, -1034 }, { 0xBE5691EF416BD60C, -1007 },
+    { 0x8DD01FAD907FFC3C,  -980 }, { 0xD3515C2831559A83,  -954 }, { 0x9D71AC8FADA6C9B5,  -927 },
+    { 0xEA9C227723EE8BCB,  -901 }, { 0xAECC49914078536D,  -874 }, { 0x823C12795DB6CE57,  -847 },
+    { 0xC21094364DFB5637,  -821 }, { 0x9096EA6F3848984F,  -794 }, { 0xD77485CB25823AC7,  -768 },
+    { 0xA086CFCD97BF97F4,  -741 }, { 0xEF340A98172AACE5,  -715 }, { 0xB23867FB2A35B28E,  -688 },
+    { 0x84C8D4DFD2C63F3B,  -661 }, { 0xC5DD44271AD3CDBA,  -635 }, { 0x936B9FCEBB25C996,  -608 },
+    { 0xDBAC6C247D62A584,  -582 }, { 0xA3AB66580D5FDAF6,  -555 }, { 0xF3E2F893DEC3F126,  -529 },
+    { 0xB5B5ADA8AAFF80B8,  -502 }, { 0x87625F056C7C4A8B,  -475 }, { 0xC9BCFF6034C13053,  -449 },
+    { 0x964E858C91BA2655,  -422 }, { 0xDFF9772470297EBD,  -396 }, { 0xA6DFBD9FB8E5B88F,  -369 },
+    { 0xF8A95FCF88747D94,  -343 }, { 0xB94470938FA89BCF,  -316 }, { 0x8A08F0F8BF0F156B,  -289 },
+    { 0xCDB02555653131B6,  -263 }, { 0x993FE2C6D07B7FAC,  -236 }, { 0xE45C10C42A2B3B06,  -210 },
+    { 0xAA242499697392D3,  -183 }, { 0xFD87B5F28300CA0E,  -157 }, { 0xBCE5086492111AEB,  -130 },
+    { 0x8CBCCC096F5088CC,  -103 }, { 0xD1B71758E219652C,   -77 }, { 0x9C40000000000000,   -50 },
+    { 0xE8D4A51000000000,   -24 }, { 0xAD78EBC5AC620000,     3 }, { 0x813F3978F8940984,    30 },
+    { 0xC097CE7BC90715B3,    56 }, { 0x8F7E32CE7BEA5C70,    83 }, { 0xD5D238A4ABE98068,   109 },
+    { 0x9F4F2726179A2245,   136 }, { 0xED63A231D4C4FB27,   162 }, { 0xB0DE65388CC8ADA8,   189 },
+    { 0x83C7088E1AAB65DB,   216 }, { 0xC45D1DF942711D9A,   242 }, { 0x924D692CA61BE758,   269 },
+    { 0xDA01EE641A708DEA,   295 }, { 0xA26DA3999AEF774A,   322 }, { 0xF209787BB47D6B85,   348 },
+    { 0xB454E4A179DD1877,   375 }, { 0x865B86925B9BC5C2,   402 }, { 0xC83553C5C8965D3D,   428 },
+    { 0x952AB45CFA97A0B3,   455 }, { 0xDE469FBD99A05FE3,   481 }, { 0xA59BC234DB398C25,   508 },
+    { 0xF6C69A72A3989F5C,   534 }, { 0xB7DCBF5354E9BECE,   561 }, { 0x88FCF317F22241E2,   588 },
+    { 0xCC20CE9BD35C78A5,   614 }, { 0x98165AF37B2153DF,   641 }, { 0xE2A0B5DC971F303A,   667 },
+    { 0xA8D9D1535CE3B396,   694 }, { 0xFB9B7CD9A4A7443C,   720 }, { 0xBB764C4CA7A44410,   747 },
+    { 0x8BAB8EEFB6409C1A,   774 }, { 0xD01FEF10A657842C,   800 }, { 0x9B10A4E5E9913129,   827 },
+    { 0xE7109BFBA19C0C9D,   853 }, { 0xAC2820D9623BF429,   880 }, { 0x80444B5E7AA7CF85,   907 },
+    { 0xBF21E44003ACDD2D,   933 }, { 0x8E679C2F5E44FF8F,   960 }, { 0xD433179D9C8CB841,   986 },
+    { 0x9E19DB92B4E31BA9,  1013 }, { 0xEB96BF6EBADF77D9,  1039 }, { 0xAF87023B9BF0EE6B,  1066 }
+};
+
+static const uint64_t json_pow10_u64[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+    10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+    1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL,
+    10000000000000000000ULL
+};
+
+static json_diyfp json_diyfp_mul(json_diyfp a, json_diyfp b) {
+    json_diyfp r;
+    uint64_t lo = json_umul128(a.f, b.f, &r.f);
+    r.f += lo >> 63; /* 四舍五入 */
+    r.e = a.e + b.e + 64;
+    return r;
+}
+
+static json_diyfp json_diyfp_normalize(json_diyfp a) {
+    int s = json_clz64(a.f);
+    a.f <<= s;
+    a.e -= s;
+    return a;
+}
+
+static void json_grisu_round(char* buffer, int len, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t wp_w) {
+    while (rest < wp_w && delta - rest >= ten_kappa &&
+           (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)) {
+        buffer[len - 1]--;
+        rest += ten_kappa;
+    }
+}
+
+static int json_grisu_digits(json_diyfp w, json_diyfp mp, uint64_t delta, char* buffer, int* k) {
+    const int shift = -mp.e;
+    const uint64_t one = 1ULL << shift, wp_w = mp.f - w.f;
+    uint32_t p1 = (uint32_t)(mp.f >> shift);
+    uint64_t p2 = mp.f & (one - 1);
+    int kappa = 1, len = 0;
+    while (kappa < 10 && p1 >= json_pow10_u64[kappa])
+        kappa++;
+    while (kappa > 0) {
+        uint32_t d = p1 / (uint32_t)json_pow10_u64[kappa - 1];
+        uint64_t rest;
+        p1 %= (uint32_t)json_pow10_u64[kappa - 1];
+        if (d || len)
+            buffer[len++] = (char)('0' + d);
+        kappa--;
+        rest = ((uint64_t)p1 << shift) + p2;
+        if (rest <= delta) {
+            *k += kappa;
+            json_grisu_round(buffer, len, delta, rest, json_pow10_u64[kappa] << shift, wp_w);
+            return len;
+        }
+    }
+    for (;;) {
+        char d;
+        p2 *= 10;
+        delta *= 10;
+        d = (char)(p2 >> shift);
+        if (d || len)
+            buffer[len++] = (char)('0' + d);
+        p2 &= one - 1;
+        kappa--;
+        if (p2 < delta) {
+            *k += kappa;
+            json_grisu_round(buffer, len, delta, p2, one, wp_w * (-kappa < 20 ? json_pow10_u64[-kappa] : 0));
+            return len;
+        }
+    }
+}
+
+/* v > 0, 写入十进制数字, 返回位数, v = digits * 10^k */
+static int json_grisu2(double v, char* buffer, int* k) {
+    json_diyfp w, mp, mm, c;
+    uint64_t bits;
+    double dk;
+    int ik, index;
+    memcpy(&bits, &v, sizeof(bits));
+    w.f = bits & 0x000FFFFFFFFFFFFFULL;
+    if (bits >> 52) { /* 正规数补上隐含的 1 */
+        w.f |= 0x0010000000000000ULL;
+        w.e = (int)(bits >> 52) - 1075;
+    }
+    else
+        w.e = -1074;
+    /* 上下边界 m+ = (2f + 1) / 2, m- = (2f - 1) / 2 (尾数为 2 的幂时下边界更近) */
+    mp.f = (w.f << 1) + 1;
+    mp.e = w.e - 1;
+    while (!(mp.f & (0x0010000000000000ULL << 1))) {
+        mp.f <<= 1;
+        mp.e--;
+    }
+    mp.f <<= 10;
+    mp.e -= 10;
+    if (w.f == 0x0010000000000000ULL) {
+        mm.f = (w.f << 2) - 1;
+        mm.e = w.e - 2;
+    }
+    else {
+        mm.f = (w.f << 1) - 1;
+        mm.e = w.e - 1;
+    }
+    mm.f <<= mm.e - mp.e;
+    mm.e = mp.e;
+    /* 选取 10^-k 使乘积的二进制指数落在 [-60, -32] */
+    dk = (-61 - mp.e) * 0.30102999566398114 + 347;
+    ik = (int)dk;
+    if (dk - ik > 0.0)
+        ik++;
+    index = (ik >> 3) + 1;
+    *k = -(-348 + index * 8);
+    c.f = json_cached_powers[index].f;
+    c.e = json_cached_powers[index].e;
+    w = json_diyfp_mul(json_diyfp_normalize(w), c);
+    mp = json_diyfp_mul(mp, c);
+    mm = json_diyfp_mul(mm, c);
+    mm.f++;
+    mp.f--;
+    return json_grisu_digits(w, mp, mp.f - mm.f, buffer, k);
+}
+
+static const char json_digits_lut[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/* 每次输出两位数字, 返回写入后的位置 */
+static char* json_u64toa(uint64_t u, char* p) {
+    char buffer[20];
+    int i = 20;
+    while (u >= 100) {
+        unsigned r = (unsigned)(u % 100) * 2;
+        u /= 100;
+        buffer[--i] = json_digits_lut[r + 1];
+        buffer[--i] = json_digits_lut[r];
+    }
+    if (u >= 10) {
+        buffer[--i] = json_digits_lut[u * 2 + 1];
+        buffer[--i] = json_digits_lut[u * 2];
+    }
+    else
+        buffer[--i] = (char)('0' + u);
+    memcpy(p, buffer + i, 20 - i);
+    return p + 20 - i;
+}
+
+static int json_format_int64(int64_t i, char* buffer) {
+    char* p = buffer;
+    uint64_t u = (uint64_t)i;
+    if (i < 0) {
+        *p++ = '-';
+        u = 0 - u;
+    }
+    return (int)(json_u64toa(u, p) - buffer);
+}
+
+/* 与 "%.17g" 相同的排版: 十进制指数在 [-4, 17) 内用定点表示, 否则用 d.ddde+XX */
+static int json_format_double(double v, char* buffer) {
+    char digits[24], *p = buffer;
+    int len, k, exp10, i;
+    uint64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    if (bits >> 63) {
+        *p++ = '-';
+        v = -v;
+    }
+    if (v == 0.0) {
+        *p++ = '0';
+        return (int)(p - buffer);
+    }
+    /* 整数快速路径 */
+    if (v < 9007199254740992.0 && v == (double)(uint64_t)v)
+        return (int)(json_u64toa((uint64_t)v, p) - buffer);
+    len = json_grisu2(v, digits, &k);
+    /* Grisu2 偶尔多给一位, 如 0.6267586510000001; 少一位舍入后若仍能还原则采用 */
+    while (len >= 16) {
+        uint64_t m = 0, m2;
+        double r;
+        int n = len - 1;
+        for (i = 0; i < n; i++)
+            m = m * 10 + (digits[i] - '0');
+        /* 先试最近的一个, 末位为 5 时另一个也可能在区间内 */
+        m2 = digits[n] >= '5' ? m : m + 1;
+        if (digits[n] >= '5')
+            m++;
+        if (!json_decimal_to_double(m, k + 1, false, &r) || r != v) {
+            m = m2;
+            if (!json_decimal_to_double(m, k + 1, false, &r) || r != v)
+                break;
+        }
+        k++;
+        for (len = 0; m; m /= 10) /* 重写数字, 去掉末尾的 0 */
+            digits[len++] = (char)('0' + m % 10);
+        for (i = 0; i < len / 2; i++) {
+            char t = digits[i];
+            digits[i] = digits[len - 1 - i];
+            digits[len - 1 - i] = t;
+        }
+        while (digits[len - 1] == '0') {
+            len--;
+            k++;
+        }
+    }
+    exp10 = len + k - 1; /* 第一位数字的十进制指数 */
+    if (exp10 >= -4 && exp10 < 17) {
+        if (k >= 0) {
+            memcpy(p, digits, len);
+            p += len;
+            for (i = 0; i < k; i++)
+                *p++ = '0';
+        }
+        else if (exp10 >= 0) {
+            memcpy(p, digits, exp10 + 1);
+            p += exp10 + 1;
+            *p++ = '.';
+            memcpy(p, digits + exp10 + 1, len - exp10 - 1);
+            p += len - exp10 - 1;
+        }
+        else {
+            *p++ = '0';
+            *p++ = '.';
+            for (i = -1; i > exp10; i--)
+                *p++ = '0';
+            memcpy(p, digits, len);
+            p += len;
+        }
+    }
+    else {
+        *p++ = digits[0];
+        if (len > 1) {
+            *p++ = '.';
+            memcpy(p, digits + 1, len - 1);
+            p += len - 1;
+        }
+        *p++ = 'e';
+        if (exp10 < 0) {
+            *p++ = '-';
+            exp10 = -exp10;
+        }
+        else
+            *p++ = '+';
+        if (exp10 >= 100) { /* 指数至少两位, 同 printf() */
+            *p++ = (char)('0' + exp10 / 100);
+            exp10 %= 100;
+        }
+        *p++ = (char)('0' + exp10 / 10);
+        *p++ = (char)('0' + exp10 % 10);
+    }
+    return (int)(p - buffer);
+}
+
 // Unoptimized
 #if 0
 static void lept_stringify_string(json_context* c, const char* s, size_t len) {
@@ -375,40 +1657,54 @@ static void lept_stringify_string(json_context* c, const char* s, size_t len) {
 
 static int json_stringify_string(json_context* context, const char* str, size_t len) {
     static const char hex_digits[] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
-    size_t size;
+    size_t size, n;
     char* head, *p;
     assert(str != NULL);
-    /* 每个字符可生成最长的形式是 `\u00XX`,占 6 个字符，以及双引号,故为 len * 6 + 2 */
-    p = head = json_context_push(context, size = len * 6 + 2); /* "\u00xx..."*/
-    *p++ = '"';
-
-    // PUTC(context, '"');
-    for (size_t i = 0; i < len; i++) {
-        unsigned char ch = (unsigned char)str[i];
-        switch (ch) {
-            case '\"': *p++ = '\\'; *p++ = '\"'; break;
-            case '\\': *p++ = '\\'; *p++ = '\\'; break;
-            case '\b': *p++ = '\\'; *p++ = 'b';  break;
-            case '\f': *p++ = '\\'; *p++ = 'f';  break;
-            case '\n': *p++ = '\\'; *p++ = 'n';  break;
-            case '\r': *p++ = '\\'; *p++ = 'r';  break;
-            case '\t': *p++ = '\\'; *p++ = 't';  break;
-            default:
-                if (ch < 0x20) {
+    PUTC(context, '"');
+    /* 输出到 sink 时分段处理, 缓冲区大小不随字符串长度增长 */
+    for (; len > 0; str += n, len -= n) {
+        n = context->sink && len > JSON_SINK_BUFFER_SIZE / 8 ? JSON_SINK_BUFFER_SIZE / 8 : len;
+        /* 每个字符可生成最长的形式是 `\u00XX`,占 6 个字符,故为 n * 6 */
+        p = head = json_context_push(context, size = n * 6); /* "\u00xx..."*/
+        for (const char* s = str, *end = str + n; ; s++) {
+            /* 不需要转义的字符整段复制, 只有 json_scan_string() 停下的字符走 switch */
+            const char* q = json_scan_string(s, end);
+            unsigned char ch;
+            memcpy(p, s, q - s);
+            p += q - s;
+            if ((s = q) == end)
+                break;
+            switch (ch = (unsigned char)*s) {
+                case '\"': *p++ = '\\'; *p++ = '\"'; break;
+                case '\\': *p++ = '\\'; *p++ = '\\'; break;
+                case '\b': *p++ = '\\'; *p++ = 'b';  break;
+                case '\f': *p++ = '\\'; *p++ = 'f';  break;
+                case '\n': *p++ = '\\'; *p++ = 'n';  break;
+                case '\r': *p++ = '\\'; *p++ = 'r';  break;
+                case '\t': *p++ = '\\'; *p++ = 't';  break;
+                default:
+                    assert(ch < 0x20);
                     *p++ = '\\'; *p++ = 'u'; *p++ = '0'; *p++ = '0';
                     *p++ = hex_digits[ch >> 4];
                     *p++ = hex_digits[ch & 15];
-                }
-                else
-                    *p++ = str[i];
+            }
         }
+        context->top -= size - (p - head);
     }
-    *p++ = '"';
-    context->top -= size - (p - head);
+    PUTC(context, '"');
     /*空间换时间*/
     /*优化的代价是可能会多分配6倍内存 且程序体积变大*/
+    return JSON_STRINGIFY_OK;
 }
 #endif
+static void json_stringify_number(json_context* context, const json_value* value) {
+    /* 最短可还原的文本, 最长 "-d.dddddddddddddddde-308" 共 24 字节 */
+    char* buffer = json_context_push(context, 32);
+    int length = value->flags & JSON_FLAG_INT64 ?
+        json_format_int64(value->i64, buffer) : json_format_double(value->num, buffer);
+    context->top -= 32 - length;
+}
+
 static int json_stringify_value(json_context* context, const json_value* value) {
     int ret;
     switch(value->type) {
@@ -416,16 +1712,7 @@ static int json_stringify_value(json_context* context, const json_value* value)
         case JSON_FALSE:    PUTS(context, "false", 5); break;
         case JSON_TRUE:     PUTS(context, "true", 4); break;
         case JSON_STRING:   json_stringify_string(context, value->str, value->len); break;
-        case JSON_NUMBER:
-            {
-                // context->top -= 32 - sprintf(json_context_push(context, 32), "%.17g", value->num); break;
-                char* buffer = json_context_push(context, 32);
-                /*使用 `sprintf("%.17g", ...)` 把双精度浮点数转换成可还原的文本*/
-                // printf("-----%.17g\n",value->num);
-                int length = sprintf(buffer, "%.17g", value->num);
-                context->top -= 32 - length;
-            }
-            break;
+        case JSON_NUMBER:   json_stringify_number(context, value); break;
         case JSON_ARRAY:
             PUTC(context, '[');
             for(size_t i = 0; i < value->size; i++) {
@@ -457,6 +1744,7 @@ int json_stringify(const json_value* value, char**json, size_t* length) {
     assert(json != NULL);
     context.stack = (char*)malloc(context.size = JSON_PARSE_STRINGIFY_INIT_SIZE);
     context.top = 0;
+    context.sink = NULL;
     if ((ret = json_stringify_value(&context, value)) != JSON_STRINGIFY_OK) {
         free(context.stack);
         *json = NULL;
@@ -470,9 +1758,248 @@ int json_stringify(const json_value* value, char**json, size_t* length) {
     return JSON_STRINGIFY_OK;
 }
 
+/* 转义后的长度 (含引号): json_scan_string() 停下的字符正是需要转义的字符 */
+static size_t json_stringify_string_size(const char* str, size_t len) {
+    const char* p = str, *end = str + len;
+    size_t size = len + 2;
+    while ((p = json_scan_string(p, end)) != end) {
+        switch (*p++) {
+            case '\"': case '\\': case '\b': case '\f': case '\n': case '\r': case '\t':
+                size += 1; break;
+            default:
+                size += 5; /* \u00XX */
+        }
+    }
+    return size;
+}
+
+static size_t json_stringify_value_size(const json_value* value) {
+    char buffer[32];
+    size_t size;
+    switch (value->type) {
+        case JSON_NULL:     return 4;
+        case JSON_FALSE:    return 5;
+        case JSON_TRUE:     return 4;
+        case JSON_STRING:   return json_stringify_string_size(value->str, value->len);
+        case JSON_NUMBER:
+            return value->flags & JSON_FLAG_INT64 ?
+                json_format_int64(value->i64, buffer) : json_format_double(value->num, buffer);
+        case JSON_ARRAY:
+            size = value->size ? value->size + 1 : 2; /* 括号和逗号 */
+            for (size_t i = 0; i < value->size; i++)
+                size += json_stringify_value_size(&value->ele[i]);
+            return size;
+        case JSON_OBJECT:
+            size = value->msize ? value->msize * 2 + 1 : 2; /* 括号、冒号和逗号 */
+            for (size_t i = 0; i < value->msize; i++)
+                size += json_stringify_string_size(value->mem[i].key, value->mem[i].keylen) +
+                        json_stringify_value_size(&value->mem[i].value);
+            return size;
+        default: assert(0 && "invalid type"); return 0;
+    }
+}
+
+size_t json_stringify_size(const json_value* value) {
+    assert(value != NULL);
+    return json_stringify_value_size(value);
+}
+
+/* 先算出准确长度, 容量足够时直接写入 buf, 不分配内存 */
+int json_stringify_into(const json_value* value, char* buf, size_t cap, size_t* length) {
+    json_context context;
+    size_t size;
+    assert(value != NULL && (buf != NULL || cap == 0));
+    size = json_stringify_value_size(value);
+    if (length)
+        *length = size;
+    if (size >= cap)
+        return JSON_STRINGIFY_BUFFER_TOO_SMALL;
+    /* 容量视为无限大, json_context_push() 永远不会 realloc(); 预留的空间大于实际写入, 但实际写入的总长已确定不超过 cap */
+    context.stack = buf;
+    context.size = (size_t)-1;
+    context.top = 0;
+    context.sink = NULL;
+    json_stringify_value(&context, value);
+    assert(context.top == size);
+    buf[size] = '\0';
+    return JSON_STRINGIFY_OK;
+}
+
+/* 输出经固定大小的缓冲区分批交给 sink, 内存占用与文档大小无关 */
+int json_stringify_to_sink(const json_value* value, json_write_fn sink, void* user) {
+    json_context context;
+    int ret;
+    assert(value != NULL && sink != NULL);
+    context.stack = (char*)malloc(context.size = JSON_SINK_BUFFER_SIZE);
+    context.top = 0;
+    context.sink = sink;
+    context.sink_user = user;
+    context.sink_error = false;
+    if ((ret = json_stringify_value(&context, value)) == JSON_STRINGIFY_OK) {
+        json_context_flush(&context);
+        if (context.sink_error)
+            ret = JSON_STRINGIFY_WRITE_ERROR;
+    }
+    free(context.stack);
+    return ret;
+}
+
+static int json_write_file(void* user, const char* data, size_t len) {
+    return fwrite(data, 1, len, (FILE*)user) != len;
+}
+
+int json_stringify_to_file(const json_value* value, FILE* fp) {
+    assert(fp != NULL);
+    return json_stringify_to_sink(value, json_write_file, fp);
+}
+
+/* write() 可能只写入一部分或被信号中断 */
+static int json_write_fd(void* user, const char* data, size_t len) {
+    int fd = *(int*)user;
+    while (len > 0) {
+#ifdef _WIN32
+        int n = _write(fd, data, (unsigned)len);
+#else
+        ssize_t n = write(fd, data, len);
+#endif
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return 1;
+        data += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+int json_stringify_to_fd(const json_value* value, int fd) {
+    return json_stringify_to_sink(value, json_write_fd, &fd);
+}
+
+/* writer: 不构建 json_value, 按调用顺序直接写入 context.stack, 输出与 json_stringify() 相同 */
+struct json_writer {
+    json_context context;
+    size_t depth;   /* 未结束的数组/对象层数 */
+    int need_comma; /* 下一个值或键之前要写 ',' */
+};
+
+json_writer* json_writer_create(void) {
+    json_writer* writer = (json_writer*)malloc(sizeof(json_writer));
+    writer->context.stack = NULL;
+    writer->context.size = writer->context.top = 0;
+    writer->context.sink = NULL;
+    writer->depth = 0;
+    writer->need_comma = false;
+    return writer;
+}
+
+void json_writer_destroy(json_writer* writer) {
+    if (writer == NULL)
+        return;
+    free(writer->context.stack);
+    free(writer);
+}
+
+static void json_writer_separate(json_writer* writer) {
+    if (writer->need_comma)
+        PUTC(&writer->context, ',');
+    writer->need_comma = true;
+}
+
+void json_writer_null(json_writer* writer) {
+    assert(writer != NULL);
+    json_writer_separate(writer);
+    PUTS(&writer->context, "null", 4);
+}
+
+void json_writer_boolean(json_writer* writer, int boolean) {
+    assert(writer != NULL);
+    json_writer_separate(writer);
+    if (boolean)
+        PUTS(&writer->context, "true", 4);
+    else
+        PUTS(&writer->context, "false", 5);
+}
+
+void json_writer_number(json_writer* writer, double number) {
+    json_value value;
+    assert(writer != NULL);
+    json_writer_separate(writer);
+    value.num = number;
+    value.flags = 0;
+    json_stringify_number(&writer->context, &value);
+}
+
+void json_writer_int64(json_writer* writer, int64_t number) {
+    json_value value;
+    assert(writer != NULL);
+    json_writer_separate(writer);
+    value.i64 = number;
+    value.flags = JSON_FLAG_INT64;
+    json_stringify_number(&writer->context, &value);
+}
+
+void json_writer_string(json_writer* writer, const char* str, size_t len) {
+    assert(writer != NULL && (str != NULL || len == 0));
+    json_writer_separate(writer);
+    json_stringify_string(&writer->context, str ? str : "", len);
+}
+
+void json_writer_key(json_writer* writer, const char* key, size_t klen) {
+    assert(writer != NULL && writer->depth > 0 && (key != NULL || klen == 0));
+    json_writer_separate(writer);
+    json_stringify_string(&writer->context, key ? key : "", klen);
+    PUTC(&writer->context, ':');
+    writer->need_comma = false; /* 键之后紧跟值 */
+}
+
+void json_writer_begin_array(json_writer* writer) {
+    assert(writer != NULL);
+    json_writer_separate(writer);
+    PUTC(&writer->context, '[');
+    writer->depth++;
+    writer->need_comma = false;
+}
+
+void json_writer_end_array(json_writer* writer) {
+    assert(writer != NULL && writer->depth > 0);
+    PUTC(&writer->context, ']');
+    writer->depth--;
+    writer->need_comma = true;
+}
+
+void json_writer_begin_object(json_writer* writer) {
+    assert(writer != NULL);
+    json_writer_separate(writer);
+    PUTC(&writer->context, '{');
+    writer->depth++;
+    writer->need_comma = false;
+}
+
+void json_writer_end_object(json_writer* writer) {
+    assert(writer != NULL && writer->depth > 0);
+    PUTC(&writer->context, '}');
+    writer->depth--;
+    writer->need_comma = true;
+}
+
+/* 与 json_stringify() 一样返回以 '\0' 结尾、需调用方 free() 的字符串; writer 随后可写下一个文档 */
+int json_writer_finish(json_writer* writer, char** json, size_t* length) {
+    assert(writer != NULL && json != NULL);
+    assert(writer->depth == 0);
+    if (length)
+        *length = writer->context.top;
+    PUTC(&writer->context, '\0');
+    *json = writer->context.stack;
+    writer->context.stack = NULL;
+    writer->context.size = writer->context.top = 0;
+    writer->need_comma = false;
+    return JSON_STRINGIFY_OK;
+}
+
 /* value = null / false / true / numver */
 static int json_parse_value(json_context* context, json_value* value) {
-    switch (*context->json) {
+    switch (PEEK(context->json, context->end)) {
         case 'n':  return json_parse_literal(context, value, "null", JSON_NULL);
         case 'f':  return json_parse_literal(context, value, "false", JSON_FALSE);
         case 't':  return json_parse_literal(context, value, "true", JSON_TRUE);
@@ -484,27 +2011,1224 @@ static int json_parse_value(json_context* context, json_value* value) {
     }
 }
 
-int json_parse(json_value* value, const char* json) {
-    json_context context;
+static int json_parse_root(json_context* context, json_value* value) {
+    int ret;
+    json_init(value);
+    json_parse_whitespace(context);
+    if ((ret = json_parse_value(context, value)) == JSON_PARSE_OK) {
+        json_parse_whitespace(context);
+        if (context->json != context->end) {
+            json_context_free_value(context, value);
+            value->type = JSON_NULL;
+            ret = JSON_PARSE_ROOT_NOT_SINGULAR;
+        }
+    }
+    assert(context->top == 0);
+    return ret;
+}
+
+static void json_context_init(json_context* context, const char* json, size_t len) {
+    context->json = json;
+    context->end = json + len;
+    context->stack = NULL;
+    context->size = context->top = 0;
+    context->arena = NULL;
+    context->insitu = false;
+    context->sink = NULL;
+    context->projection = NULL;
+}
+
+int json_parse(json_value* value, const char* json) {
+    assert(json != NULL);
+    return json_parse_n(value, json, strlen(json));
+}
+
+int json_parse_n(json_value* value, const char* json, size_t len) {
+    json_context context;
+    int ret;
+    assert(value != NULL && (json != NULL || len == 0));
+    json_context_init(&context, json, len);
+    ret = json_parse_root(&context, value);
+    free(context.stack);
+    return ret;
+}
+
+int json_validate(const char* json, size_t len) {
+    json_context context;
+    int ret;
+    assert(json != NULL || len == 0);
+    json_context_init(&context, json, len);
+    json_parse_whitespace(&context);
+    if ((ret = json_skip_value(&context)) == JSON_PARSE_OK) {
+        json_parse_whitespace(&context);
+        if (context.json != context.end)
+            ret = JSON_PARSE_ROOT_NOT_SINGULAR;
+    }
+    free(context.stack); /* 只有超过 63 字符的数字才会用到栈 */
+    return ret;
+}
+
+int json_parse_arena(json_arena* arena, json_value* value, const char* json) {
+    json_context context;
+    int ret;
+    assert(arena != NULL && value != NULL && json != NULL);
+    json_context_init(&context, json, strlen(json));
+    context.arena = arena;
+    ret = json_parse_root(&context, value);
+    free(context.stack);
+    return ret;
+}
+
+int json_parse_insitu(json_arena* arena, json_value* value, char* json, size_t len) {
+    json_context context;
+    int ret;
+    assert(arena != NULL && value != NULL && (json != NULL || len == 0));
+    json_context_init(&context, json, len);
+    context.arena = arena;
+    context.insitu = true;
+    ret = json_parse_root(&context, value);
+    free(context.stack);
+    return ret;
+}
+
+/* 无法映射的输入 (管道、空文件等) 整个读入内存 */
+static int json_read_fd(int fd, char** buf, size_t* len) {
+    size_t cap = 1 << 16;
+    *buf = (char*)malloc(cap);
+    *len = 0;
+    while (1) {
+#ifdef _WIN32
+        int n = _read(fd, *buf + *len, (unsigned)(cap - *len));
+#else
+        ssize_t n = read(fd, *buf + *len, cap - *len);
+#endif
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0) {
+            free(*buf);
+            return JSON_PARSE_FILE_ERROR;
+        }
+        if (n == 0)
+            return JSON_PARSE_OK;
+        if ((*len += (size_t)n) == cap)
+            *buf = (char*)realloc(*buf, cap <<= 1);
+    }
+}
+
+/* 普通文件用 mmap() 映射后直接解析, 不经过 read() 复制; 字符串仍然复制到 value 中, 映射在返回前解除 */
+int json_parse_file(json_value* value, const char* path) {
+    char* buf;
+    size_t len;
+    int fd, ret;
+    assert(value != NULL && path != NULL);
+#ifdef _WIN32
+    fd = _open(path, _O_RDONLY | _O_BINARY);
+#else
+    fd = open(path, O_RDONLY);
+#endif
+    if (fd < 0) {
+        json_init(value);
+        return JSON_PARSE_FILE_ERROR;
+    }
+#ifndef _WIN32
+    {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 && (uint64_t)st.st_size <= SIZE_MAX) {
+            void* addr = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED) {
+                close(fd);
+                madvise(addr, (size_t)st.st_size, MADV_SEQUENTIAL); /* 预读, 并尽早回收读过的页 */
+                ret = json_parse_n(value, (const char*)addr, (size_t)st.st_size);
+                munmap(addr, (size_t)st.st_size);
+                return ret;
+            }
+        }
+    }
+#endif
+    ret = json_read_fd(fd, &buf, &len);
+#ifdef _WIN32
+    _close(fd);
+#else
+    close(fd);
+#endif
+    if (ret != JSON_PARSE_OK) {
+        json_init(value);
+        return ret;
+    }
+    ret = json_parse_n(value, buf, len);
+    free(buf);
+    return ret;
+}
+
+#ifndef JSON_NO_THREADS
+/* 并行解析顶层数组: 先扫描一遍找到深度为 1 的逗号作为分段点, 各段由不同线程解析后拼接 */
+typedef struct {
+    json_context context; /* [json, end) 为一段以逗号分隔的元素 */
+    size_t size; /* 解析出的元素数, 在 context.stack 上 */
+    int ret;
+}json_parallel_part;
+
+static void* json_parallel_worker(void* arg) {
+    json_parallel_part* part = (json_parallel_part*)arg;
+    json_context* context = &part->context;
+    while (1) {
+        json_value ele;
+        json_init(&ele);
+        json_parse_whitespace(context);
+        if ((part->ret = json_parse_value(context, &ele)) != JSON_PARSE_OK)
+            return NULL;
+        memcpy(json_context_push(context, sizeof(json_value)), &ele, sizeof(json_value));
+        part->size++;
+        json_parse_whitespace(context);
+        if (context->json == context->end)
+            return NULL;
+        if (*context->json++ != ',') {
+            part->ret = JSON_PARSE_MISS_COMMA_OR_SQUARE_BRACKET;
+            return NULL;
+        }
+    }
+}
+
+/* 只跟踪字符串和括号深度, 不检查文法; 在第 k 个目标位置之后的第一个顶层逗号处分段 */
+/* 返回分段点个数, *close 为匹配的 ']'; 括号不闭合或字符串未结束时返回 -1 */
+static int json_parallel_split(const char* p, const char* end, const char** splits, int n, const char** close) {
+    const char* start = p;
+    size_t len = end - p, depth = 0;
+    int k = 0;
+    assert(*p == '[');
+    for (; p < end; p++) {
+        switch (*p) {
+            case '"':
+                for (p++; ; p++) {
+                    if ((p = json_scan_string(p, end)) == end)
+                        return -1;
+                    if (*p == '"')
+                        break;
+                    if (*p == '\\' && ++p == end)
+                        return -1;
+                }
+                break;
+            case '[': case '{':
+                depth++;
+                break;
+            case ']': case '}':
+                if (--depth == 0) {
+                    /* 段内括号的配对由各段的解析检查, 根数组的结尾只能在这里检查 */
+                    if (*p != ']')
+                        return -1;
+                    *close = p;
+                    return k;
+                }
+                break;
+            case ',':
+                if (depth == 1 && k < n && (size_t)(p - start) >= len / (n + 1) * (k + 1))
+                    splits[k++] = p;
+                break;
+        }
+    }
+    return -1;
+}
+#endif
+
+/* 根为大数组时分段并行解析; 其它情况以及出错时退回 json_parse_n(), 结果和错误码与之相同 */
+int json_parse_parallel(json_value* value, const char* json, size_t len, unsigned threads) {
+#ifndef JSON_NO_THREADS
+    const char* p, *end = json + len, *close, **splits;
+    json_parallel_part* parts;
+    pthread_t* tids;
+    size_t size = 0;
+    int n, started = 0, ret = JSON_PARSE_OK;
+    assert(value != NULL && (json != NULL || len == 0));
+    if (threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (unsigned)cpus : 1;
+    }
+    if (threads > len / JSON_PARALLEL_MIN_SEGMENT)
+        threads = (unsigned)(len / JSON_PARALLEL_MIN_SEGMENT);
+    p = json_skip_whitespace(json, end);
+    if (threads < 2 || p == end || *p != '[')
+        return json_parse_n(value, json, len);
+
+    splits = (const char**)malloc((threads - 1) * sizeof(const char*));
+    n = json_parallel_split(p, end, splits, (int)threads - 1, &close);
+    if (n <= 0 || json_skip_whitespace(close + 1, end) != end) {
+        free(splits);
+        return json_parse_n(value, json, len);
+    }
+    parts = (json_parallel_part*)malloc((n + 1) * sizeof(json_parallel_part));
+    tids = (pthread_t*)malloc(n * sizeof(pthread_t));
+    for (int i = 0; i <= n; i++) {
+        const char* begin = i == 0 ? p + 1 : splits[i - 1] + 1;
+        json_context_init(&parts[i].context, begin, (i == n ? close : splits[i]) - begin);
+        parts[i].size = 0;
+    }
+    while (started < n && pthread_create(&tids[started], NULL, json_parallel_worker, &parts[started + 1]) == 0)
+        started++;
+    for (int i = started; i < n; i++) /* 线程创建失败的段由调用线程解析 */
+        json_parallel_worker(&parts[i + 1]);
+    json_parallel_worker(&parts[0]);
+    while (started)
+        pthread_join(tids[--started], NULL);
+
+    for (int i = 0; i <= n; i++) {
+        size += parts[i].size;
+        if (parts[i].ret != JSON_PARSE_OK)
+            ret = parts[i].ret;
+    }
+    json_init(value);
+    if (ret == JSON_PARSE_OK) {
+        value->type = JSON_ARRAY;
+        value->size = size;
+        value->ele = (json_value*)malloc(size * sizeof(json_value));
+        size = 0;
+    }
+    for (int i = 0; i <= n; i++) {
+        json_context* context = &parts[i].context;
+        if (ret == JSON_PARSE_OK)
+            memcpy(value->ele + size, context->stack, context->top);
+        else
+            while (context->top)
+                json_free((json_value*)json_context_pop(context, sizeof(json_value)));
+        size += parts[i].size;
+        free(context->stack);
+    }
+    free(parts);
+    free(tids);
+    free(splits);
+    /* 分段解析不知道出错位置之前的文法, 重新串行解析得到一致的错误码 */
+    return ret == JSON_PARSE_OK ? ret : json_parse_n(value, json, len);
+#else
+    (void)threads;
+    return json_parse_n(value, json, len);
+#endif
+}
+
+/* 两阶段解析 (simdjson): 第一阶段按 64 字节一块用 SIMD 生成位图, 得到所有 token 的起始位置 (结构索引); */
+/* 第二阶段按索引逐个 token 构建 json_value, 不再逐字符判断空白和结构字符 */
+typedef struct {
+    uint64_t quote, backslash, op, ws; /* 每字节一位 */
+}json_block;
+
+static void json_classify_block(const char* p, json_block* b) {
+#if defined(JSON_SIMD_SSE2)
+    const __m128i quote = _mm_set1_epi8('"'), slash = _mm_set1_epi8('\\'), lower = _mm_set1_epi8(0x20),
+        lcurly = _mm_set1_epi8('{'), rcurly = _mm_set1_epi8('}'), colon = _mm_set1_epi8(':'), comma = _mm_set1_epi8(','),
+        sp = _mm_set1_epi8(' '), tab = _mm_set1_epi8('\t'), lf = _mm_set1_epi8('\n'), cr = _mm_set1_epi8('\r');
+    b->quote = b->backslash = b->op = b->ws = 0;
+    for (int i = 0; i < 64; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(p + i));
+        __m128i xl = _mm_or_si128(x, lower); /* '[' ']' 与 '{' '}' 只差 0x20 */
+        __m128i op = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(xl, lcurly), _mm_cmpeq_epi8(xl, rcurly)),
+                                  _mm_or_si128(_mm_cmpeq_epi8(x, colon), _mm_cmpeq_epi8(x, comma)));
+        __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, sp), _mm_cmpeq_epi8(x, tab)),
+                                  _mm_or_si128(_mm_cmpeq_epi8(x, lf), _mm_cmpeq_epi8(x, cr)));
+        b->quote |= (uint64_t)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, quote)) << i;
+        b->backslash |= (uint64_t)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, slash)) << i;
+        b->op |= (uint64_t)(unsigned)_mm_movemask_epi8(op) << i;
+        b->ws |= (uint64_t)(unsigned)_mm_movemask_epi8(ws) << i;
+    }
+#else
+    b->quote = b->backslash = b->op = b->ws = 0;
+    for (int i = 0; i < 64; i++) {
+        uint64_t bit = (uint64_t)1 << i;
+        switch (p[i]) {
+            case '"':  b->quote |= bit; break;
+            case '\\': b->backslash |= bit; break;
+            case '{': case '}': case '[': case ']': case ':': case ',': b->op |= bit; break;
+            case ' ': case '\t': case '\n': case '\r': b->ws |= bit; break;
+        }
+    }
+#endif
+}
+
+/* 第 i 位为第 0...i 位的异或, 即该位置是否在一对引号之间 (含开引号) */
+static uint64_t json_prefix_xor(uint64_t x) {
+#if defined(JSON_SIMD_PCLMUL)
+    return (uint64_t)_mm_cvtsi128_si64(_mm_clmulepi64_si128(_mm_set_epi64x(0, (long long)x), _mm_set1_epi8((char)0xFF), 0));
+#else
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+#endif
+}
+
+/* 被转义的字符: 反斜杠很少见, 逐个处理; prev_escaped 为上一块末尾的反斜杠转义了本块第 0 位 */
+static uint64_t json_escaped_mask(uint64_t backslash, uint64_t* prev_escaped) {
+    uint64_t escaped = *prev_escaped;
+    *prev_escaped = 0;
+    for (; backslash; backslash &= backslash - 1) {
+        unsigned i = json_ctz64(backslash);
+        if (escaped >> i & 1)
+            continue;
+        if (i == 63)
+            *prev_escaped = 1;
+        else
+            escaped |= (uint64_t)1 << (i + 1);
+    }
+    return escaped;
+}
+
+/* token 起始位置: 字符串外的结构字符、开引号、数字/字面量的首字符; 末尾追加 len 作为哨兵 */
+/* 字符串未结束时返回 (size_t)-1 */
+static size_t json_build_index(const char* json, size_t len, uint32_t** index) {
+    uint32_t* idx = NULL;
+    size_t n = 0, cap = 0;
+    uint64_t prev_in_string = 0, prev_scalar = 0, prev_escaped = 0;
+    for (size_t pos = 0; pos < len; pos += 64) {
+        json_block b;
+        uint64_t escaped, quotes, in_string, scalar, tokens;
+        char buffer[64];
+        const char* p = json + pos;
+        if (len - pos < 64) { /* 最后一块用空白补齐 */
+            memset(buffer, ' ', sizeof(buffer));
+            memcpy(buffer, p, len - pos);
+            p = buffer;
+        }
+        json_classify_block(p, &b);
+        escaped = json_escaped_mask(b.backslash, &prev_escaped);
+        quotes = b.quote & ~escaped;
+        in_string = json_prefix_xor(quotes) ^ prev_in_string;
+        prev_in_string = (uint64_t)((int64_t)in_string >> 63);
+        scalar = ~(b.op | b.ws | b.quote) & ~in_string;
+        tokens = (b.op & ~in_string) | (quotes & in_string) | (scalar & ~(scalar << 1 | prev_scalar));
+        prev_scalar = scalar >> 63;
+        if (n + 64 >= cap) {
+            cap = cap ? cap + (cap >> 1) + 64 : len / 4 + 128;
+            idx = (uint32_t*)realloc(idx, cap * sizeof(uint32_t));
+        }
+        for (; tokens; tokens &= tokens - 1)
+            idx[n++] = (uint32_t)(pos + json_ctz64(tokens));
+    }
+    if (prev_in_string) {
+        free(idx);
+        return (size_t)-1;
+    }
+    if (n + 1 > cap)
+        idx = (uint32_t*)realloc(idx, (n + 1) * sizeof(uint32_t));
+    idx[n] = (uint32_t)len;
+    *index = idx;
+    return n;
+}
+
+typedef struct {
+    json_context context;
+    const char* json;
+    const uint32_t* index;
+    size_t i; /* 当前 token */
+}json_index_context;
+
+/* 当前 token 消费到 p 为止; 到下一个 token 之间只能有空白, 这保证了整个输入都经过检查 */
+static int json_index_next(json_index_context* c, const char* p) {
+    c->i++;
+    return json_skip_whitespace(p, c->context.end) == c->json + c->index[c->i];
+}
+
+#define INDEX_TOKEN(c)  PEEK((c)->json + (c)->index[(c)->i], (c)->context.end)
+#define INDEX_SKIP(c)   json_index_next(c, (c)->json + (c)->index[(c)->i] + 1)
+
+/* 第二阶段只需判断是否出错, 具体的错误码由 json_parse_n() 重新解析得到 */
+#define INDEX_ERROR     JSON_PARSE_INVALID_VALUE
+
+static int json_index_value(json_index_context* c, json_value* value);
+
+static int json_index_array(json_index_context* c, json_value* value) {
+    size_t size = 0;
+    int ret = INDEX_ERROR;
+    if (!INDEX_SKIP(c))
+        return INDEX_ERROR;
+    if (INDEX_TOKEN(c) == ']') {
+        value->type = JSON_ARRAY;
+        value->size = 0;
+        value->ele = NULL;
+        return INDEX_SKIP(c) ? JSON_PARSE_OK : INDEX_ERROR;
+    }
+    while (1) {
+        json_value ele;
+        json_init(&ele);
+        if ((ret = json_index_value(c, &ele)) != JSON_PARSE_OK)
+            break;
+        memcpy(json_context_push(&c->context, sizeof(json_value)), &ele, sizeof(json_value));
+        size++;
+        ret = INDEX_ERROR;
+        if (INDEX_TOKEN(c) == ',') {
+            if (!INDEX_SKIP(c))
+                break;
+        }
+        else if (INDEX_TOKEN(c) == ']') {
+            if (!INDEX_SKIP(c))
+                break;
+            value->type = JSON_ARRAY;
+            value->size = size;
+            size *= sizeof(json_value);
+            value->ele = (json_value*)malloc(size);
+            memcpy(value->ele, json_context_pop(&c->context, size), size);
+            return JSON_PARSE_OK;
+        }
+        else
+            break;
+    }
+    for (size_t i = 0; i < size; i++)
+        json_free((json_value*)json_context_pop(&c->context, sizeof(json_value)));
+    return ret;
+}
+
+static int json_index_object(json_index_context* c, json_value* value) {
+    size_t size = 0;
+    json_member mem;
+    int ret = INDEX_ERROR;
+    if (!INDEX_SKIP(c))
+        return INDEX_ERROR;
+    if (INDEX_TOKEN(c) == '}') {
+        value->type = JSON_OBJECT;
+        value->mem = NULL;
+        value->msize = 0;
+        value->flags = 0;
+        return INDEX_SKIP(c) ? JSON_PARSE_OK : INDEX_ERROR;
+    }
+    mem.key = NULL;
+    while (1) {
+        char* str;
+        json_init(&mem.value);
+        ret = INDEX_ERROR;
+        if (INDEX_TOKEN(c) != '"')
+            break;
+        c->context.json = c->json + c->index[c->i];
+        if ((ret = json_parse_string_raw(&c->context, &str, &mem.keylen)) != JSON_PARSE_OK)
+            break;
+        ret = INDEX_ERROR;
+        if (!json_index_next(c, c->context.json) || INDEX_TOKEN(c) != ':' || !INDEX_SKIP(c))
+            break;
+        mem.key = (char*)malloc(mem.keylen + 1);
+        if (mem.keylen)
+            memcpy(mem.key, str, mem.keylen);
+        mem.key[mem.keylen] = '\0';
+        if ((ret = json_index_value(c, &mem.value)) != JSON_PARSE_OK)
+            break;
+        memcpy(json_context_push(&c->context, sizeof(json_member)), &mem, sizeof(json_member));
+        size++;
+        mem.key = NULL;
+        ret = INDEX_ERROR;
+        if (INDEX_TOKEN(c) == ',') {
+            if (!INDEX_SKIP(c))
+                break;
+        }
+        else if (INDEX_TOKEN(c) == '}') {
+            if (!INDEX_SKIP(c))
+                break;
+            json_context_pop_object(&c->context, value, size);
+            return JSON_PARSE_OK;
+        }
+        else
+            break;
+    }
+    free(mem.key);
+    for (size_t i = 0; i < size; i++) {
+        json_member* m = (json_member*)json_context_pop(&c->context, sizeof(json_member));
+        free(m->key);
+        json_free(&m->value);
+    }
+    return ret;
+}
+
+static int json_index_value(json_index_context* c, json_value* value) {
+    int ret;
+    switch (INDEX_TOKEN(c)) {
+        case '[':  return json_index_array(c, value);
+        case '{':  return json_index_object(c, value);
+        default:
+            /* 字符串和标量仍用 json_parse_value() 解析, 结尾必须紧接 (空白和) 下一个 token */
+            c->context.json = c->json + c->index[c->i];
+            if ((ret = json_parse_value(&c->context, value)) != JSON_PARSE_OK)
+                return ret;
+            if (!json_index_next(c, c->context.json)) {
+                json_free(value);
+                json_init(value);
+                return INDEX_ERROR;
+            }
+            return JSON_PARSE_OK;
+    }
+}
+
+int json_parse_indexed(json_value* value, const char* json, size_t len) {
+    json_index_context c;
+    uint32_t* index;
+    size_t n;
+    int ret;
+    assert(value != NULL && (json != NULL || len == 0));
+    if (len >= UINT32_MAX || (n = json_build_index(json, len, &index)) == (size_t)-1)
+        return json_parse_n(value, json, len);
+    json_init(value);
+    json_context_init(&c.context, json, len);
+    c.json = json;
+    c.index = index;
+    c.i = 0;
+    ret = INDEX_ERROR;
+    if (json_skip_whitespace(json, c.context.end) == json + index[0] && (ret = json_index_value(&c, value)) == JSON_PARSE_OK && c.i != n) {
+        json_free(value);
+        ret = INDEX_ERROR;
+    }
+    assert(c.context.top == 0);
+    free(c.context.stack);
+    free(index);
+    if (ret != JSON_PARSE_OK) {
+        json_init(value);
+        return json_parse_n(value, json, len);
+    }
+    return ret;
+}
+
+/* 可复用的 context: 栈在多次调用之间保留, 处理大量小文档时只分配一次 */
+json_context* json_context_create(void) {
+    json_context* context = (json_context*)malloc(sizeof(json_context));
+    context->stack = NULL;
+    context->size = context->top = 0;
+    return context;
+}
+
+/* 释放已增长的栈, 例如处理过一个特别大的文档之后 */
+void json_context_reset(json_context* context) {
+    assert(context != NULL);
+    free(context->stack);
+    context->stack = NULL;
+    context->size = context->top = 0;
+}
+
+void json_context_destroy(json_context* context) {
+    if (context == NULL)
+        return;
+    free(context->stack);
+    free(context);
+}
+
+int json_context_parse(json_context* context, json_value* value, const char* json, size_t len) {
+    assert(context != NULL && value != NULL && (json != NULL || len == 0));
+    context->json = json;
+    context->end = json + len;
+    context->top = 0;
+    context->arena = NULL;
+    context->insitu = false;
+    context->sink = NULL;
+    context->projection = NULL;
+    return json_parse_root(context, value);
+}
+
+int json_context_stringify(json_context* context, const json_value* value, const char** json, size_t* length) {
+    int ret;
+    assert(context != NULL && value != NULL && json != NULL);
+    context->top = 0;
+    context->sink = NULL;
+    if ((ret = json_stringify_value(context, value)) != JSON_STRINGIFY_OK) {
+        *json = NULL;
+        return ret;
+    }
+    if (length)
+        *length = context->top;
+    PUTC(context, '\0');
+    *json = context->stack;
+    return JSON_STRINGIFY_OK;
+}
+
+/* NDJSON: 每行一个文档; 合法 JSON 的字符串中不会出现未转义的换行, 所以按 '\n' 切分是安全的 */
+/* 返回 [p, end) 中第一条非空行的位置, len 为行长 (不含 '\n'); 没有则返回 NULL */
+static const char* json_ndjson_line(const char* p, const char* end, size_t* len) {
+    while (p < end) {
+        const char* q = (const char*)memchr(p, '\n', end - p);
+        if (q == NULL)
+            q = end;
+        if (json_skip_whitespace(p, q) != q) {
+            *len = q - p;
+            return p;
+        }
+        p = q + 1;
+    }
+    return NULL;
+}
+
+int json_ndjson_next(json_context* context, json_value* value, const char** json, const char* end) {
+    const char* line;
+    size_t len;
+    assert(context != NULL && value != NULL && json != NULL && *json <= end);
+    if ((line = json_ndjson_line(*json, end, &len)) == NULL) {
+        *json = end;
+        json_init(value);
+        return JSON_PARSE_END;
+    }
+    *json = line + len < end ? line + len + 1 : end;
+    return json_context_parse(context, value, line, len);
+}
+
+typedef struct {
+    const char* json;
+    json_ndjson_record* records;
+    size_t count;
+    size_t next; /* 下一批待领取的记录 */
+#ifndef JSON_NO_THREADS
+    pthread_mutex_t lock;
+#endif
+}json_ndjson_batch;
+
+/* 每个工作线程使用自己的 json_context, 按批领取记录 */
+static void* json_ndjson_worker(void* arg) {
+    json_ndjson_batch* batch = (json_ndjson_batch*)arg;
+    json_context* context = json_context_create();
+    while (1) {
+        size_t i, n;
+#ifndef JSON_NO_THREADS
+        pthread_mutex_lock(&batch->lock);
+#endif
+        i = batch->next;
+        batch->next = i + JSON_NDJSON_BATCH < batch->count ? i + JSON_NDJSON_BATCH : batch->count;
+        n = batch->next;
+#ifndef JSON_NO_THREADS
+        pthread_mutex_unlock(&batch->lock);
+#endif
+        if (i == n)
+            break;
+        for (; i < n; i++) {
+            json_ndjson_record* r = &batch->records[i];
+            r->error = json_context_parse(context, &r->value, batch->json + r->offset, r->length);
+        }
+    }
+    json_context_destroy(context);
+    return NULL;
+}
+
+size_t json_parse_ndjson(const char* json, size_t len, json_ndjson_record** records, unsigned threads) {
+    json_ndjson_batch batch;
+    const char* p, *end = json + len, *line;
+    size_t cap = 0, n;
+    assert((json != NULL || len == 0) && records != NULL);
+    /* 先串行切分, 只记录每条记录的位置 */
+    batch.json = json;
+    batch.records = NULL;
+    batch.count = batch.next = 0;
+    for (p = json; (line = json_ndjson_line(p, end, &n)) != NULL; p = line + n < end ? line + n + 1 : end) {
+        if (batch.count == cap) {
+            cap = cap ? cap + (cap >> 1) : 256;
+            batch.records = (json_ndjson_record*)realloc(batch.records, cap * sizeof(json_ndjson_record));
+        }
+        batch.records[batch.count].offset = line - json;
+        batch.records[batch.count].length = n;
+        batch.count++;
+    }
+#ifndef JSON_NO_THREADS
+    {
+        pthread_t* tids;
+        unsigned started = 0;
+        if (threads == 0) {
+            long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+            threads = cpus > 0 ? (unsigned)cpus : 1;
+        }
+        if (threads > (batch.count + JSON_NDJSON_BATCH - 1) / JSON_NDJSON_BATCH)
+            threads = (unsigned)((batch.count + JSON_NDJSON_BATCH - 1) / JSON_NDJSON_BATCH);
+        tids = threads > 1 ? (pthread_t*)malloc((threads - 1) * sizeof(pthread_t)) : NULL;
+        pthread_mutex_init(&batch.lock, NULL);
+        while (started + 1 < threads && pthread_create(&tids[started], NULL, json_ndjson_worker, &batch) == 0)
+            started++;
+        json_ndjson_worker(&batch); /* 调用线程也参与 */
+        while (started)
+            pthread_join(tids[--started], NULL);
+        pthread_mutex_destroy(&batch.lock);
+        free(tids);
+    }
+#else
+    (void)threads;
+    json_ndjson_worker(&batch);
+#endif
+    *records = batch.records;
+    return batch.count;
+}
+
+void json_ndjson_free(json_ndjson_record* records, size_t count) {
+    for (size_t i = 0; i < count; i++)
+        json_free(&records[i].value);
+    free(records);
+}
+
+/* SAX: 与 json_parse_value() 相同的文法, 不构建节点, 每个值以事件回调给 handler */
+#define SAX_EVENT(h, cb, ...)  do { if ((h)->cb && (h)->cb(__VA_ARGS__)) return JSON_PARSE_HANDLER_ABORT; } while(0)
+
+static int json_sax_value(json_context* context, const json_handler* handler, void* user);
+
+static int json_sax_array(json_context* context, const json_handler* handler, void* user) {
+    size_t size = 0;
+    int ret;
+    EXPECT(context, '[');
+    SAX_EVENT(handler, start_array, user);
+    json_parse_whitespace(context);
+    if (PEEK(context->json, context->end) == ']') {
+        context->json++;
+        SAX_EVENT(handler, end_array, user, 0);
+        return JSON_PARSE_OK;
+    }
+    while (1) {
+        if ((ret = json_sax_value(context, handler, user)) != JSON_PARSE_OK)
+            return ret;
+        size++;
+        json_parse_whitespace(context);
+        if (PEEK(context->json, context->end) == ',') {
+            context->json++;
+            json_parse_whitespace(context);
+        }
+        else if (PEEK(context->json, context->end) == ']') {
+            context->json++;
+            SAX_EVENT(handler, end_array, user, size);
+            return JSON_PARSE_OK;
+        }
+        else
+            return JSON_PARSE_MISS_COMMA_OR_SQUARE_BRACKET;
+    }
+}
+
+static int json_sax_object(json_context* context, const json_handler* handler, void* user) {
+    size_t size = 0, len;
+    char* str;
+    int ret;
+    EXPECT(context, '{');
+    SAX_EVENT(handler, start_object, user);
+    json_parse_whitespace(context);
+    if (PEEK(context->json, context->end) == '}') {
+        context->json++;
+        SAX_EVENT(handler, end_object, user, 0);
+        return JSON_PARSE_OK;
+    }
+    while (1) {
+        if (PEEK(context->json, context->end) != '"')
+            return JSON_PARSE_MISS_KEY;
+        if ((ret = json_parse_string_raw(context, &str, &len)) != JSON_PARSE_OK)
+            return ret;
+        SAX_EVENT(handler, key, user, str, len);
+        json_parse_whitespace(context);
+        if (PEEK(context->json, context->end) != ':')
+            return JSON_PARSE_MISS_COLON;
+        context->json++;
+        json_parse_whitespace(context);
+        if ((ret = json_sax_value(context, handler, user)) != JSON_PARSE_OK)
+            return ret;
+        size++;
+        json_parse_whitespace(context);
+        if (PEEK(context->json, context->end) == ',') {
+            context->json++;
+            json_parse_whitespace(context);
+        }
+        else if (PEEK(context->json, context->end) == '}') {
+            context->json++;
+            SAX_EVENT(handler, end_object, user, size);
+            return JSON_PARSE_OK;
+        }
+        else
+            return JSON_PARSE_MISS_COMMA_OR_CURLY_BRACKET;
+    }
+}
+
+static int json_sax_value(json_context* context, const json_handler* handler, void* user) {
+    json_value v; /* 标量不分配内存, 临时存放即可 */
+    char* str;
+    size_t len;
+    int ret;
+    switch (PEEK(context->json, context->end)) {
+        case 'n':
+            if ((ret = json_parse_literal(context, &v, "null", JSON_NULL)) == JSON_PARSE_OK)
+                SAX_EVENT(handler, null, user);
+            return ret;
+        case 'f':
+            if ((ret = json_parse_literal(context, &v, "false", JSON_FALSE)) == JSON_PARSE_OK)
+                SAX_EVENT(handler, boolean, user, 0);
+            return ret;
+        case 't':
+            if ((ret = json_parse_literal(context, &v, "true", JSON_TRUE)) == JSON_PARSE_OK)
+                SAX_EVENT(handler, boolean, user, 1);
+            return ret;
+        default:
+            if ((ret = json_parse_number(context, &v)) != JSON_PARSE_OK)
+                return ret;
+            if (v.flags & JSON_FLAG_INT64 && handler->int64)
+                SAX_EVENT(handler, int64, user, v.i64);
+            else
+                SAX_EVENT(handler, number, user, json_get_number(&v));
+            return JSON_PARSE_OK;
+        case '"':
+            /* str 指向 context->stack, 只在回调期间有效 */
+            if ((ret = json_parse_string_raw(context, &str, &len)) == JSON_PARSE_OK)
+                SAX_EVENT(handler, string, user, str, len);
+            return ret;
+        case '[':  return json_sax_array(context, handler, user);
+        case '{':  return json_sax_object(context, handler, user);
+        case '\0': return JSON_PARSE_EXPECT_VALUE;
+    }
+}
+
+int json_parse_sax(const json_handler* handler, void* user, const char* json, size_t len) {
+    json_context context;
+    int ret;
+    assert(handler != NULL && (json != NULL || len == 0));
+    json_context_init(&context, json, len);
+    json_parse_whitespace(&context);
+    if ((ret = json_sax_value(&context, handler, user)) == JSON_PARSE_OK) {
+        json_parse_whitespace(&context);
+        if (context.json != context.end)
+            ret = JSON_PARSE_ROOT_NOT_SINGULAR;
+    }
+    free(context.stack);
+    return ret;
+}
+
+/* 增量解析: 文档分块到达, 每块 feed() 一次, 状态在块之间保存在 json_parser 中 */
+/* 与 json_parse_value() 同样的文法, 但用显式的容器栈代替递归, 以便在任意字节处暂停 */
+enum {
+    JSON_PARSER_VALUE,        /* 期待值 */
+    JSON_PARSER_VALUE_OR_END, /* '[' 之后, 期待值或 ']' */
+    JSON_PARSER_KEY,          /* 对象中 ',' 之后, 期待键 */
+    JSON_PARSER_KEY_OR_END,   /* '{' 之后, 期待键或 '}' */
+    JSON_PARSER_COLON,        /* 键之后, 期待 ':' */
+    JSON_PARSER_COMMA,        /* 元素/成员之后, 期待 ',' 或右括号 */
+    JSON_PARSER_DONE          /* 根值已完成, 之后只允许空白 */
+};
+
+typedef struct {
+    size_t size;  /* 已完成的元素/成员数, 它们在 context.stack 上 */
+    char type;    /* '[' 或 '{' */
+    char has_key; /* 栈顶有一个只有键、等待值的成员 */
+}json_parser_frame;
+
+struct json_parser {
+    json_context context;
+    json_parser_frame* frames;
+    size_t depth, frame_cap;
+    int state;
+    int error; /* 出错后不再接受输入, 直到 finish() */
+    json_value root;
+    /* 在块尾被截断的字符串/数字/字面量, 拼接完整后再解析 */
+    char* token;
+    size_t token_len, token_cap;
+    char token_type;   /* 0: 无, '"': 字符串, 'a': 数字或字面量 */
+    int token_escape;  /* 字符串截断在 '\\' 之后 */
+};
+
+/* 数字和字面量可能包含的字符, 遇到其它字符即可确定 token 已完整 */
+#define ISTOKEN(ch)         (ISDIGIT(ch) || ((ch) >= 'a' && (ch) <= 'z') || (ch) == 'E' || (ch) == '+' || (ch) == '-' || (ch) == '.')
+
+/* 从字符串内部 p 开始找结尾的 '"', 返回其后的位置; 到 end 仍未结束则返回 NULL, escape 记录是否停在 '\\' 之后 */
+static const char* json_scan_string_end(const char* p, const char* end, int* escape) {
+    if (*escape) {
+        if (p == end)
+            return NULL;
+        p++;
+        *escape = false;
+    }
+    while ((p = json_scan_string(p, end)) != end) {
+        if (*p == '"')
+            return p + 1;
+        if (*p++ == '\\') {
+            if (p == end) {
+                *escape = true;
+                return NULL;
+            }
+            p++;
+        }
+        /* 控制字符留给 json_parse_string_raw() 报错 */
+    }
+    return NULL;
+}
+
+static const char* json_scan_token_end(const char* p, const char* end) {
+    while (p < end && ISTOKEN(*p))
+        p++;
+    return p != end ? p : NULL;
+}
+
+static void json_parser_token_append(json_parser* parser, const char* s, size_t len) {
+    if (parser->token_len + len > parser->token_cap) {
+        size_t cap = parser->token_cap ? parser->token_cap : 64;
+        while (cap < parser->token_len + len)
+            cap += cap >> 1;
+        parser->token = (char*)realloc(parser->token, cap);
+        parser->token_cap = cap;
+    }
+    if (len)
+        memcpy(parser->token + parser->token_len, s, len);
+    parser->token_len += len;
+}
+
+/* 一个值完成: 成为根, 压入数组, 或填入栈顶成员 */
+static void json_parser_add(json_parser* parser, const json_value* value) {
+    json_parser_frame* frame;
+    if (parser->depth == 0) {
+        parser->root = *value;
+        parser->state = JSON_PARSER_DONE;
+        return;
+    }
+    frame = &parser->frames[parser->depth - 1];
+    if (frame->type == '[')
+        memcpy(json_context_push(&parser->context, sizeof(json_value)), value, sizeof(json_value));
+    else {
+        ((json_member*)(parser->context.stack + parser->context.top - sizeof(json_member)))->value = *value;
+        frame->has_key = false;
+    }
+    frame->size++;
+    parser->state = JSON_PARSER_COMMA;
+}
+
+static void json_parser_open(json_parser* parser, char type) {
+    json_parser_frame* frame;
+    if (parser->depth == parser->frame_cap) {
+        parser->frame_cap = parser->frame_cap ? parser->frame_cap << 1 : 16;
+        parser->frames = (json_parser_frame*)realloc(parser->frames, parser->frame_cap * sizeof(json_parser_frame));
+    }
+    frame = &parser->frames[parser->depth++];
+    frame->size = 0;
+    frame->type = type;
+    frame->has_key = false;
+    parser->state = type == '[' ? JSON_PARSER_VALUE_OR_END : JSON_PARSER_KEY_OR_END;
+}
+
+/* 与 json_parse_array()/json_parse_object() 结尾相同的方式出栈生成容器 */
+static void json_parser_close(json_parser* parser) {
+    json_parser_frame* frame = &parser->frames[--parser->depth];
+    json_value value;
+    json_init(&value);
+    if (frame->type == '[') {
+        size_t size = frame->size * sizeof(json_value);
+        value.type = JSON_ARRAY;
+        value.size = frame->size;
+        value.ele = NULL;
+        if (size) {
+            value.ele = (json_value*)malloc(size);
+            memcpy(value.ele, json_context_pop(&parser->context, size), size);
+        }
+    }
+    else if (frame->size == 0) {
+        value.type = JSON_OBJECT;
+        value.mem = NULL;
+        value.msize = 0;
+    }
+    else
+        json_context_pop_object(&parser->context, &value, frame->size);
+    json_parser_add(parser, &value);
+}
+
+/* 释放尚未完成的容器、根值和截断的 token, 回到初始状态 */
+static void json_parser_clear(json_parser* parser) {
+    while (parser->depth) {
+        json_parser_frame* frame = &parser->frames[--parser->depth];
+        if (frame->type == '[') {
+            for (size_t i = 0; i < frame->size; i++)
+                json_free((json_value*)json_context_pop(&parser->context, sizeof(json_value)));
+            continue;
+        }
+        for (size_t i = 0; i < frame->size + frame->has_key; i++) {
+            json_member* m = (json_member*)json_context_pop(&parser->context, sizeof(json_member));
+            free(m->key);
+            json_free(&m->value);
+        }
+    }
+    assert(parser->context.top == 0);
+    if (parser->state == JSON_PARSER_DONE)
+        json_free(&parser->root);
+    parser->state = JSON_PARSER_VALUE;
+    parser->token_type = 0;
+    parser->token_len = 0;
+}
+
+/* 解析一个完整的字符串/数字/字面量 token: 对象中是键, 否则是值 */
+static int json_parser_token(json_parser* parser, const char** p, const char* end) {
+    json_context* context = &parser->context;
+    int ret;
+    context->json = *p;
+    context->end = end;
+    if (parser->state == JSON_PARSER_KEY || parser->state == JSON_PARSER_KEY_OR_END) {
+        json_member m;
+        char* str;
+        if ((ret = json_parse_string_raw(context, &str, &m.keylen)) != JSON_PARSE_OK)
+            return ret;
+        m.key = (char*)malloc(m.keylen + 1);
+        if (m.keylen)
+            memcpy(m.key, str, m.keylen);
+        m.key[m.keylen] = '\0';
+        json_init(&m.value);
+        memcpy(json_context_push(context, sizeof(json_member)), &m, sizeof(json_member));
+        parser->frames[parser->depth - 1].has_key = true;
+        parser->state = JSON_PARSER_COLON;
+    }
+    else {
+        json_value value;
+        json_init(&value);
+        if ((ret = json_parse_value(context, &value)) != JSON_PARSE_OK)
+            return ret;
+        json_parser_add(parser, &value);
+    }
+    *p = context->json;
+    return JSON_PARSE_OK;
+}
+
+/* 处理 [p, end), more 表示之后还有输入, 此时块尾被截断的 token 保存起来等待下一块 */
+static int json_parser_run(json_parser* parser, const char* p, const char* end, int more) {
     int ret;
-    assert(value != NULL);
-    context.json = json;
-    context.stack = NULL;
-    context.size = context.top = 0;
+    while (1) {
+        const char* q;
+        int escape = false;
+        char ch;
+        p = json_skip_whitespace(p, end);
+        if (p == end)
+            return JSON_PARSE_OK;
+        ch = *p;
+        switch (parser->state) {
+            case JSON_PARSER_DONE:
+                return JSON_PARSE_ROOT_NOT_SINGULAR;
+            case JSON_PARSER_COLON:
+                if (ch != ':')
+                    return JSON_PARSE_MISS_COLON;
+                p++;
+                parser->state = JSON_PARSER_VALUE;
+                continue;
+            case JSON_PARSER_COMMA:
+                if (parser->frames[parser->depth - 1].type == '[') {
+                    if (ch == ',')
+                        parser->state = JSON_PARSER_VALUE;
+                    else if (ch == ']')
+                        json_parser_close(parser);
+                    else
+                        return JSON_PARSE_MISS_COMMA_OR_SQUARE_BRACKET;
+                }
+                else {
+                    if (ch == ',')
+                        parser->state = JSON_PARSER_KEY;
+                    else if (ch == '}')
+                        json_parser_close(parser);
+                    else
+                        return JSON_PARSE_MISS_COMMA_OR_CURLY_BRACKET;
+                }
+                p++;
+                continue;
+            case JSON_PARSER_KEY_OR_END:
+                if (ch == '}') {
+                    p++;
+                    json_parser_close(parser);
+                    continue;
+                }
+                /* fall through */
+            case JSON_PARSER_KEY:
+                if (ch != '"')
+                    return JSON_PARSE_MISS_KEY;
+                break;
+            case JSON_PARSER_VALUE_OR_END:
+                if (ch == ']') {
+                    p++;
+                    json_parser_close(parser);
+                    continue;
+                }
+                /* fall through */
+            default:
+                if (ch == '[' || ch == '{') {
+                    p++;
+                    json_parser_open(parser, ch);
+                    continue;
+                }
+                break;
+        }
+        q = ch == '"' ? json_scan_string_end(p + 1, end, &escape) : json_scan_token_end(p, end);
+        if (q == NULL && more) {
+            parser->token_type = ch == '"' ? '"' : 'a';
+            parser->token_escape = escape;
+            json_parser_token_append(parser, p, end - p);
+            return JSON_PARSE_OK;
+        }
+        if ((ret = json_parser_token(parser, &p, end)) != JSON_PARSE_OK)
+            return ret;
+    }
+}
+
+json_parser* json_parser_create(void) {
+    json_parser* parser = (json_parser*)malloc(sizeof(json_parser));
+    parser->context.stack = NULL;
+    parser->context.size = parser->context.top = 0;
+    parser->context.arena = NULL;
+    parser->context.insitu = false;
+    parser->context.sink = NULL;
+    parser->context.projection = NULL;
+    parser->frames = NULL;
+    parser->depth = parser->frame_cap = 0;
+    parser->state = JSON_PARSER_VALUE;
+    parser->error = JSON_PARSE_OK;
+    parser->token = NULL;
+    parser->token_len = parser->token_cap = 0;
+    parser->token_type = 0;
+    parser->token_escape = false;
+    return parser;
+}
+
+int json_parser_feed(json_parser* parser, const char* chunk, size_t len) {
+    const char* end;
+    int ret = JSON_PARSE_OK;
+    assert(parser != NULL && (chunk != NULL || len == 0));
+    if (parser->error != JSON_PARSE_OK || len == 0)
+        return parser->error;
+    end = chunk + len;
+    if (parser->token_type) {
+        /* 先补全上一块截断的 token, 再单独解析它 */
+        const char* q = parser->token_type == '"' ? json_scan_string_end(chunk, end, &parser->token_escape) : json_scan_token_end(chunk, end);
+        json_parser_token_append(parser, chunk, (q ? q : end) - chunk);
+        if (q == NULL)
+            return JSON_PARSE_OK;
+        parser->token_type = 0;
+        ret = json_parser_run(parser, parser->token, parser->token + parser->token_len, false);
+        parser->token_len = 0;
+        chunk = q;
+    }
+    if (ret == JSON_PARSE_OK)
+        ret = json_parser_run(parser, chunk, end, true);
+    if (ret != JSON_PARSE_OK) {
+        json_parser_clear(parser);
+        parser->error = ret;
+    }
+    return ret;
+}
+
+int json_parser_finish(json_parser* parser, json_value* value) {
+    int ret;
+    assert(parser != NULL && value != NULL);
     json_init(value);
-    json_parse_whitespace(&context);
-    if ((ret = json_parse_value(&context, value)) == JSON_PARSE_OK) {
-        json_parse_whitespace(&context);
-        if (*context.json != '\0') {
-            value->type = JSON_NULL;
-            return JSON_PARSE_ROOT_NOT_SINGULAR;
+    ret = parser->error;
+    if (ret == JSON_PARSE_OK && parser->token_type) {
+        /* 输入结束, 截断的 token 按原样解析 */
+        parser->token_type = 0;
+        ret = json_parser_run(parser, parser->token, parser->token + parser->token_len, false);
+    }
+    if (ret == JSON_PARSE_OK) {
+        switch (parser->state) {
+            case JSON_PARSER_DONE:
+                *value = parser->root;
+                parser->state = JSON_PARSER_VALUE;
+                break;
+            case JSON_PARSER_KEY:
+            case JSON_PARSER_KEY_OR_END: ret = JSON_PARSE_MISS_KEY; break;
+            case JSON_PARSER_COLON:      ret = JSON_PARSE_MISS_COLON; break;
+            case JSON_PARSER_COMMA:
+                ret = parser->frames[parser->depth - 1].type == '[' ?
+                    JSON_PARSE_MISS_COMMA_OR_SQUARE_BRACKET : JSON_PARSE_MISS_COMMA_OR_CURLY_BRACKET;
+                break;
+            default:                     ret = JSON_PARSE_EXPECT_VALUE; break;
         }
     }
-    assert(context.top == 0);
-    free(context.stack);
+    json_parser_clear(parser);
+    parser->error = JSON_PARSE_OK;
     return ret;
 }
 
+void json_parser_destroy(json_parser* parser) {
+    if (parser == NULL)
+        return;
+    json_parser_clear(parser);
+    free(parser->context.stack);
+    free(parser->frames);
+    free(parser->token);
+    free(parser);
+}
+
 void json_free(json_value* value) {
     assert(value != NULL);
     /* JSON_STRING => JSON_NULL 避免重复释放 */
@@ -559,7 +3283,8 @@ void json_set_string(json_value* value, const char* str, size_t len) {
     assert(value != NULL && (str != NULL || len == 0));
     json_free(value);
     value->str = (char*)malloc(len + 1);
-    memcpy(value->str, str, len);
+    if (len)
+        memcpy(value->str, str, len);
     value->str[len] = '\0';
     value->len = len;
     value->type = JSON_STRING;
@@ -567,13 +3292,33 @@ void json_set_string(json_value* value, const char* str, size_t len) {
 
 double json_get_number(const json_value* value) {
     assert(value != NULL && value->type == JSON_NUMBER);
-    return value->num;
+    return value->flags & JSON_FLAG_INT64 ? (double)value->i64 : value->num;
 }
 
 void json_set_number(json_value* value, double number) {
     assert(value != NULL);
+    json_free(value);
     value->num = number;
     value->type = JSON_NUMBER;
+    value->flags = 0;
+}
+
+int json_is_int64(const json_value* value) {
+    assert(value != NULL && value->type == JSON_NUMBER);
+    return (value->flags & JSON_FLAG_INT64) != 0;
+}
+
+int64_t json_get_int64(const json_value* value) {
+    assert(value != NULL && value->type == JSON_NUMBER);
+    return value->flags & JSON_FLAG_INT64 ? value->i64 : (int64_t)value->num;
+}
+
+void json_set_int64(json_value* value, int64_t number) {
+    assert(value != NULL);
+    json_free(value);
+    value->i64 = number;
+    value->type = JSON_NUMBER;
+    value->flags = JSON_FLAG_INT64;
 }
 
 json_type json_get_type(const json_value* value) {
@@ -611,4 +3356,735 @@ json_value* json_get_object_value(const json_value* value, size_t index) {
     assert(value != NULL && value->type == JSON_OBJECT);
     assert(index < value->msize);
     return &value->mem[index].value;
-}
\ No newline at end of file
+}
+
+size_t json_find_object_index(const json_value* value, const char* key, size_t klen) {
+    assert(value != NULL && value->type == JSON_OBJECT && (key != NULL || klen == 0));
+    if (value->flags & JSON_FLAG_INDEXED) {
+        const uint32_t* table = (const uint32_t*)(value->mem + value->msize);
+        size_t mask = json_object_index_capacity(value->msize) - 1;
+        size_t slot = json_hash_key(key, klen) & mask;
+        for (; table[slot]; slot = (slot + 1) & mask) {
+            const json_member* m = &value->mem[table[slot] - 1];
+            if (m->keylen == klen && memcmp(m->key, key, klen) == 0)
+                return table[slot] - 1;
+        }
+        return JSON_KEY_NOT_EXIST;
+    }
+    for (size_t i = 0; i < value->msize; i++)
+        if (value->mem[i].keylen == klen && memcmp(value->mem[i].key, key, klen) == 0)
+            return i;
+    return JSON_KEY_NOT_EXIST;
+}
+
+json_value* json_find_object_value(const json_value* value, const char* key, size_t klen) {
+    size_t index = json_find_object_index(value, key, klen);
+    return index != JSON_KEY_NOT_EXIST ? &value->mem[index].value : NULL;
+}
+
+/* 紧凑只读格式: 所有节点 16 字节, 连续存放在一块内存中, 用 32 位下标互相引用 */
+/* 容器的子节点连续存放, 对象的子节点为 键, 值, 键, 值 ...; 不超过 11 字节的字符串内联在节点中 */
+/* 其它字符串和键存放在节点之后的字符串池, 相同的键只存一份 */
+#define JSON_NODE_INLINE 0x4 /* 字符串内联在 s 中 */
+#define JSON_NODE_INLINE_MAX 11
+
+struct json_node {
+    uint8_t type;
+    uint8_t flags; /* JSON_FLAG_INT64 / JSON_NODE_INLINE */
+    uint8_t ilen;  /* 内联字符串长度 */
+    uint8_t reserved;
+    union {
+        struct {
+            uint32_t a; /* 字符串: 长度; 容器: 子节点数 (对象为成员数) */
+            uint32_t b; /* 字符串: 池中偏移; 容器: 第一个子节点 */
+            uint32_t c;
+        };
+        char s[12];     /* 内联字符串, 以 '\0' 结尾 */
+    };
+};
+
+typedef char json_node_size_check[sizeof(json_node) == 16 ? 1 : -1];
+
+struct json_tape {
+    json_node* nodes; /* 根为 nodes[0] */
+    const char* pool;
+    size_t count, pool_size;
+};
+
+typedef struct {
+    json_node* nodes;
+    size_t count, cap;
+    char* pool;
+    size_t pool_size, pool_cap;
+    uint32_t* keys; /* 键的驻留表, 槽中为 (偏移, 长度) */
+    size_t key_mask, key_count;
+    int too_large;
+}json_tape_builder;
+
+static size_t json_tape_alloc(json_tape_builder* b, size_t n) {
+    size_t first = b->count;
+    if (b->count + n > b->cap) {
+        while (b->count + n > b->cap)
+            b->cap = b->cap ? b->cap + (b->cap >> 1) : 64;
+        b->nodes = (json_node*)realloc(b->nodes, b->cap * sizeof(json_node));
+    }
+    b->count += n;
+    return first;
+}
+
+static size_t json_tape_pool_add(json_tape_builder* b, const char* s, size_t len) {
+    size_t off = b->pool_size;
+    if (b->pool_size + len + 1 > b->pool_cap) {
+        while (b->pool_size + len + 1 > b->pool_cap)
+            b->pool_cap = b->pool_cap ? b->pool_cap + (b->pool_cap >> 1) : 256;
+        b->pool = (char*)realloc(b->pool, b->pool_cap);
+    }
+    memcpy(b->pool + off, s, len);
+    b->pool[off + len] = '\0';
+    b->pool_size += len + 1;
+    return off;
+}
+
+/* 相同的键返回同一个池偏移 */
+static size_t json_tape_intern(json_tape_builder* b, const char* key, size_t klen) {
+    size_t slot;
+    if (b->key_count * 2 >= b->key_mask) {
+        /* 扩容并重新插入 */
+        uint32_t* old = b->keys;
+        size_t old_cap = b->keys ? b->key_mask + 1 : 0;
+        b->key_mask = old_cap ? old_cap * 2 - 1 : 63;
+        b->keys = (uint32_t*)calloc((b->key_mask + 1) * 2, sizeof(uint32_t));
+        for (size_t i = 0; i < old_cap; i++) {
+            if (old[i * 2 + 1] == 0)
+                continue;
+            slot = json_hash_key(b->pool + old[i * 2], old[i * 2 + 1] - 1) & b->key_mask;
+            while (b->keys[slot * 2 + 1])
+                slot = (slot + 1) & b->key_mask;
+            b->keys[slot * 2] = old[i * 2];
+            b->keys[slot * 2 + 1] = old[i * 2 + 1];
+        }
+        free(old);
+    }
+    /* 长度存为 klen + 1, 0 表示空槽 */
+    for (slot = json_hash_key(key, klen) & b->key_mask; b->keys[slot * 2 + 1]; slot = (slot + 1) & b->key_mask)
+        if (b->keys[slot * 2 + 1] == klen + 1 && memcmp(b->pool + b->keys[slot * 2], key, klen) == 0)
+            return b->keys[slot * 2];
+    b->keys[slot * 2] = (uint32_t)json_tape_pool_add(b, key, klen);
+    b->keys[slot * 2 + 1] = (uint32_t)(klen + 1);
+    b->key_count++;
+    return b->keys[slot * 2];
+}
+
+static void json_tape_string(json_tape_builder* b, size_t i, const char* s, size_t len, int key) {
+    json_node* node = &b->nodes[i];
+    node->type = JSON_STRING;
+    if (len <= JSON_NODE_INLINE_MAX) {
+        node->flags = JSON_NODE_INLINE;
+        node->ilen = (uint8_t)len;
+        memcpy(node->s, s, len);
+        node->s[len] = '\0';
+        return;
+    }
+    if (len >= UINT32_MAX) {
+        b->too_large = true;
+        return;
+    }
+    node->a = (uint32_t)len;
+    node->b = (uint32_t)(key ? json_tape_intern(b, s, len) : json_tape_pool_add(b, s, len));
+}
+
+/* 先为容器的所有子节点占好连续的位置, 再逐个递归填充 */
+static void json_tape_emit(json_tape_builder* b, size_t i, const json_value* value) {
+    size_t first, size;
+    json_node* node = &b->nodes[i];
+    memset(node, 0, sizeof(json_node));
+    node->type = (uint8_t)value->type;
+    switch (value->type) {
+        case JSON_NUMBER:
+            node->flags = value->flags & JSON_FLAG_INT64;
+            memcpy(&node->b, &value->num, sizeof(double)); /* b, c */
+            break;
+        case JSON_STRING:
+            json_tape_string(b, i, value->str, value->len, false);
+            break;
+        case JSON_ARRAY:
+            size = value->size;
+            first = json_tape_alloc(b, size);
+            b->nodes[i].a = (uint32_t)size;
+            b->nodes[i].b = (uint32_t)first;
+            for (size_t k = 0; k < size; k++)
+                json_tape_emit(b, first + k, &value->ele[k]);
+            break;
+        case JSON_OBJECT:
+            size = value->msize;
+            first = json_tape_alloc(b, size * 2);
+            b->nodes[i].a = (uint32_t)size;
+            b->nodes[i].b = (uint32_t)first;
+            for (size_t k = 0; k < size; k++) {
+                memset(&b->nodes[first + k * 2], 0, sizeof(json_node));
+                json_tape_string(b, first + k * 2, value->mem[k].key, value->mem[k].keylen, true);
+                json_tape_emit(b, first + k * 2 + 1, &value->mem[k].value);
+            }
+            break;
+        default:
+            break;
+    }
+    if (b->count >= UINT32_MAX || b->pool_size >= UINT32_MAX)
+        b->too_large = true;
+}
+
+json_tape* json_tape_from_value(const json_value* value) {
+    json_tape_builder b;
+    json_tape* tape = NULL;
+    assert(value != NULL);
+    memset(&b, 0, sizeof(b));
+    json_tape_emit(&b, json_tape_alloc(&b, 1), value);
+    if (!b.too_large) {
+        /* 结构体、节点和字符串池放在同一块内存中 */
+        tape = (json_tape*)malloc(sizeof(json_tape) + b.count * sizeof(json_node) + b.pool_size);
+        tape->nodes = (json_node*)(tape + 1);
+        tape->count = b.count;
+        tape->pool_size = b.pool_size;
+        memcpy(tape->nodes, b.nodes, b.count * sizeof(json_node));
+        if (b.pool_size)
+            memcpy(tape->nodes + b.count, b.pool, b.pool_size);
+        tape->pool = (const char*)(tape->nodes + b.count);
+    }
+    free(b.nodes);
+    free(b.pool);
+    free(b.keys);
+    return tape;
+}
+
+/* 中间的 json_value 从 arena 分配, 转换后整体释放 */
+int json_parse_tape(json_tape** tape, const char* json, size_t len) {
+    json_arena arena;
+    json_value value;
+    json_context context;
+    int ret;
+    assert(tape != NULL && (json != NULL || len == 0));
+    *tape = NULL;
+    json_arena_init(&arena);
+    json_context_init(&context, json, len);
+    context.arena = &arena;
+    if ((ret = json_parse_root(&context, &value)) == JSON_PARSE_OK && (*tape = json_tape_from_value(&value)) == NULL)
+        ret = JSON_PARSE_TOO_LARGE;
+    free(context.stack);
+    json_arena_free(&arena);
+    return ret;
+}
+
+void json_tape_free(json_tape* tape) {
+    free(tape);
+}
+
+size_t json_tape_size(const json_tape* tape) {
+    assert(tape != NULL);
+    return sizeof(json_tape) + tape->count * sizeof(json_node) + tape->pool_size;
+}
+
+const json_node* json_tape_root(const json_tape* tape) {
+    assert(tape != NULL);
+    return tape->nodes;
+}
+
+json_type json_tape_get_type(const json_node* node) {
+    assert(node != NULL);
+    return (json_type)node->type;
+}
+
+double json_tape_get_number(const json_node* node) {
+    double d;
+    int64_t i;
+    assert(node != NULL && node->type == JSON_NUMBER);
+    if (node->flags & JSON_FLAG_INT64) {
+        memcpy(&i, &node->b, sizeof(i));
+        return (double)i;
+    }
+    memcpy(&d, &node->b, sizeof(d));
+    return d;
+}
+
+int json_tape_is_int64(const json_node* node) {
+    assert(node != NULL && node->type == JSON_NUMBER);
+    return (node->flags & JSON_FLAG_INT64) != 0;
+}
+
+int64_t json_tape_get_int64(const json_node* node) {
+    int64_t i;
+    assert(node != NULL && node->type == JSON_NUMBER && (node->flags & JSON_FLAG_INT64));
+    memcpy(&i, &node->b, sizeof(i));
+    return i;
+}
+
+const char* json_tape_get_string(const json_tape* tape, const json_node* node) {
+    assert(tape != NULL && node != NULL && node->type == JSON_STRING);
+    return node->flags & JSON_NODE_INLINE ? node->s : tape->pool + node->b;
+}
+
+size_t json_tape_get_string_length(const json_node* node) {
+    assert(node != NULL && node->type == JSON_STRING);
+    return node->flags & JSON_NODE_INLINE ? node->ilen : node->a;
+}
+
+size_t json_tape_get_array_size(const json_node* node) {
+    assert(node != NULL && node->type == JSON_ARRAY);
+    return node->a;
+}
+
+const json_node* json_tape_get_array_element(const json_tape* tape, const json_node* node, size_t index) {
+    assert(tape != NULL && node != NULL && node->type == JSON_ARRAY && index < node->a);
+    return &tape->nodes[node->b + index];
+}
+
+size_t json_tape_get_object_size(const json_node* node) {
+    assert(node != NULL && node->type == JSON_OBJECT);
+    return node->a;
+}
+
+const char* json_tape_get_object_key(const json_tape* tape, const json_node* node, size_t index) {
+    assert(tape != NULL && node != NULL && node->type == JSON_OBJECT && index < node->a);
+    return json_tape_get_string(tape, &tape->nodes[node->b + index * 2]);
+}
+
+size_t json_tape_get_object_key_length(const json_tape* tape, const json_node* node, size_t index) {
+    assert(tape != NULL && node != NULL && node->type == JSON_OBJECT && index < node->a);
+    return json_tape_get_string_length(&tape->nodes[node->b + index * 2]);
+}
+
+const json_node* json_tape_get_object_value(const json_tape* tape, const json_node* node, size_t index) {
+    assert(tape != NULL && node != NULL && node->type == JSON_OBJECT && index < node->a);
+    return &tape->nodes[node->b + index * 2 + 1];
+}
+
+/* 键重复时返回第一个 */
+const json_node* json_tape_find_object_value(const json_tape* tape, const json_node* node, const char* key, size_t klen) {
+    assert(tape != NULL && node != NULL && node->type == JSON_OBJECT && (key != NULL || klen == 0));
+    for (size_t i = 0; i < node->a; i++) {
+        const json_node* k = &tape->nodes[node->b + i * 2];
+        if (json_tape_get_string_length(k) == klen && memcmp(json_tape_get_string(tape, k), key, klen) == 0)
+            return k + 1;
+    }
+    return NULL;
+}
+
+/* 结构化跳过: 只跟踪引号、转义和括号深度, 不检查其余文法, 不使用 json_context 的栈 */
+typedef struct {
+    uint64_t quote, backslash, open, close; /* 每字节一位 */
+}json_bracket_block;
+
+static void json_classify_brackets(const char* p, json_bracket_block* b) {
+#if defined(JSON_SIMD_SSE2)
+    const __m128i quote = _mm_set1_epi8('"'), slash = _mm_set1_epi8('\\'), lower = _mm_set1_epi8(0x20),
+        lcurly = _mm_set1_epi8('{'), rcurly = _mm_set1_epi8('}');
+    b->quote = b->backslash = b->open = b->close = 0;
+    for (int i = 0; i < 64; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(p + i));
+        __m128i xl = _mm_or_si128(x, lower); /* '[' ']' 与 '{' '}' 只差 0x20 */
+        b->quote |= (uint64_t)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, quote)) << i;
+        b->backslash |= (uint64_t)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, slash)) << i;
+        b->open |= (uint64_t)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(xl, lcurly)) << i;
+        b->close |= (uint64_t)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(xl, rcurly)) << i;
+    }
+#else
+    b->quote = b->backslash = b->open = b->close = 0;
+    for (int i = 0; i < 64; i++) {
+        uint64_t bit = (uint64_t)1 << i;
+        switch (p[i]) {
+            case '"':  b->quote |= bit; break;
+            case '\\': b->backslash |= bit; break;
+            case '{': case '[': b->open |= bit; break;
+            case '}': case ']': b->close |= bit; break;
+        }
+    }
+#endif
+}
+
+/* p 指向 '[' 或 '{', 按 64 字节一块数括号: 本块的右括号不足以回到深度 0 时整块跳过 */
+/* 只检查最外层的左右括号是否配对, 内层只计深度 */
+static const char* json_skip_container(const char* p, const char* end) {
+    const char* start = p;
+    uint64_t prev_in_string = 0, prev_escaped = 0;
+    size_t depth = 0;
+    for (; p < end; p += 64) {
+        json_bracket_block b;
+        uint64_t quotes, in_string, open, close;
+        char buffer[64];
+        const char* q = p;
+        if (end - p < 64) { /* 最后一块用空白补齐 */
+            memset(buffer, ' ', sizeof(buffer));
+            memcpy(buffer, p, end - p);
+            q = buffer;
+        }
+        json_classify_brackets(q, &b);
+        quotes = b.quote & ~json_escaped_mask(b.backslash, &prev_escaped);
+        in_string = json_prefix_xor(quotes) ^ prev_in_string;
+        prev_in_string = (uint64_t)((int64_t)in_string >> 63);
+        open = b.open & ~in_string;
+        close = b.close & ~in_string;
+        if (json_popcount64(close) < depth) {
+            depth = depth + json_popcount64(open) - json_popcount64(close);
+            continue;
+        }
+        for (uint64_t m = open | close; m; m &= m - 1) {
+            unsigned i = json_ctz64(m);
+            if (open >> i & 1)
+                depth++;
+            else if (--depth == 0)
+                return p[i] == (*start == '[' ? ']' : '}') ? p + i + 1 : NULL;
+        }
+    }
+    return NULL;
+}
+
+/* 返回值之后的位置, 字符串或容器未结束、多余的右括号或没有值时返回 NULL */
+static const char* json_skip_structural(const char* p, const char* end) {
+    switch (PEEK(p, end)) {
+        case '"':
+            for (p++; ; p++) {
+                if ((p = json_scan_string(p, end)) == end)
+                    return NULL;
+                if (*p == '"')
+                    return p + 1;
+                if (*p == '\\' && ++p == end)
+                    return NULL;
+            }
+        case '[': case '{':
+            return json_skip_container(p, end);
+        case ']': case '}': case ',': case ':': case '\0':
+            return NULL;
+        default:
+            /* 数字/字面量 */
+            do
+                p++;
+            while (p < end && !ISWS(*p) && *p != ',' && *p != ':' && *p != '"' && *p != '[' && *p != '{' && *p != ']' && *p != '}');
+            return p;
+    }
+}
+
+size_t json_skip(const char* json, size_t len) {
+    const char* end = json + len, *p;
+    assert(json != NULL || len == 0);
+    p = json_skip_structural(json_skip_whitespace(json, end), end);
+    return p ? (size_t)(p - json) : 0;
+}
+
+/* 惰性解析: json_lazy 只记录值在文本中的起始位置, 访问时才跳过/解析需要的部分 */
+/* 跳过的子树用 json_skip_structural(), 不做完整检查; json_lazy_get_value() 取值时完整解析 */
+/* 由值的首字符判断类型; 不可能是值的开头时返回 JSON_PARSE_EXPECT_VALUE (没有值) 或 JSON_PARSE_INVALID_VALUE */
+/* 与 json_parse_value() 在同一位置报告的错误码一致, 因此 json_lazy 只会停在合法的值开头 */
+static int json_lazy_type(const char* p, const char* end, json_type* type) {
+    switch (PEEK(p, end)) {
+        case 'n': *type = JSON_NULL; break;
+        case 'f': *type = JSON_FALSE; break;
+        case 't': *type = JSON_TRUE; break;
+        case '"': *type = JSON_STRING; break;
+        case '[': *type = JSON_ARRAY; break;
+        case '{': *type = JSON_OBJECT; break;
+        case '-': case '0': case '1': case '2': case '3': case '4':
+        case '5': case '6': case '7': case '8': case '9':
+            *type = JSON_NUMBER;
+            break;
+        case '\0': return JSON_PARSE_EXPECT_VALUE;
+        default:   return JSON_PARSE_INVALID_VALUE;
+    }
+    return JSON_PARSE_OK;
+}
+
+int json_lazy_parse(json_lazy* lazy, const char* json, size_t len) {
+    const char* end = json + len;
+    json_type type;
+    int ret;
+    assert(lazy != NULL && (json != NULL || len == 0));
+    lazy->json = json_skip_whitespace(json, end);
+    lazy->end = end;
+    if ((ret = json_lazy_type(lazy->json, end, &type)) != JSON_PARSE_OK)
+        lazy->json = NULL;
+    return ret;
+}
+
+json_type json_lazy_get_type(const json_lazy* lazy) {
+    json_type type = JSON_NULL;
+    int ret;
+    assert(lazy != NULL && lazy->json != NULL);
+    ret = json_lazy_type(lazy->json, lazy->end, &type);
+    assert(ret == JSON_PARSE_OK);
+    (void)ret;
+    return type;
+}
+
+int json_lazy_get_value(const json_lazy* lazy, json_value* value) {
+    json_context context;
+    int ret;
+    assert(lazy != NULL && lazy->json != NULL && value != NULL);
+    json_context_init(&context, lazy->json, lazy->end - lazy->json);
+    json_init(value);
+    ret = json_parse_value(&context, value);
+    /* 跳过时 "null7" 这样的标量被当作一个元素, 不能只取出其中的 null */
+    if (ret == JSON_PARSE_OK && context.json != context.end && !ISWS(*context.json) &&
+        *context.json != ',' && *context.json != ']' && *context.json != '}') {
+        json_free(value);
+        ret = JSON_PARSE_INVALID_VALUE;
+    }
+    free(context.stack);
+    return ret;
+}
+
+/* 逐个跳过元素直到第 index 个; element 为 NULL 时只计数 */
+static int json_lazy_array(const json_lazy* array, size_t index, json_lazy* element, size_t* size) {
+    const char* p, *end = array->end;
+    size_t i = 0;
+    json_type type;
+    int ret;
+    assert(array != NULL && array->json != NULL && *array->json == '[');
+    p = json_skip_whitespace(array->json + 1, end);
+    if (PEEK(p, end) != ']') {
+        for (; ; i++) {
+            /* "[1,]" "[1,,2]" 等在这里报错, 不会数出或返回不存在的元素 */
+            if ((ret = json_lazy_type(p, end, &type)) != JSON_PARSE_OK)
+                return ret;
+            if (i == index && element) {
+                element->json = p;
+                element->end = end;
+                return JSON_PARSE_OK;
+            }
+            if ((p = json_skip_structural(p, end)) == NULL)
+                return JSON_PARSE_INVALID_VALUE;
+            p = json_skip_whitespace(p, end);
+            if (PEEK(p, end) == ',')
+                p = json_skip_whitespace(p + 1, end);
+            else if (PEEK(p, end) == ']')
+                break;
+            else
+                return JSON_PARSE_MISS_COMMA_OR_SQUARE_BRACKET;
+        }
+        i++;
+    }
+    if (element)
+        element->json = NULL;
+    if (size)
+        *size = i;
+    return JSON_PARSE_OK;
+}
+
+int json_lazy_get_array_element(const json_lazy* array, size_t index, json_lazy* element) {
+    assert(element != NULL);
+    return json_lazy_array(array, index, element, NULL);
+}
+
+int json_lazy_get_array_size(const json_lazy* array, size_t* size) {
+    assert(size != NULL);
+    return json_lazy_array(array, (size_t)-1, NULL, size);
+}
+
+/* 比较 *p 处的键, 没有转义时直接比较原文 */
+static int json_lazy_key(const char** p, const char* end, const char* key, size_t klen, int* equal) {
+    const char* q = json_scan_string(*p + 1, end);
+    json_context context;
+    char* str;
+    size_t len;
+    int ret;
+    if (q < end && *q == '"') {
+        *equal = (size_t)(q - *p - 1) == klen && memcmp(*p + 1, key, klen) == 0;
+        *p = q + 1;
+        return JSON_PARSE_OK;
+    }
+    json_context_init(&context, *p, end - *p);
+    if ((ret = json_parse_string_raw(&context, &str, &len)) == JSON_PARSE_OK) {
+        *equal = len == klen && memcmp(str, key, klen) == 0;
+        *p = context.json;
+    }
+    free(context.stack);
+    return ret;
+}
+
+/* key 为 NULL 时只计数 */
+static int json_lazy_object(const json_lazy* object, const char* key, size_t klen, json_lazy* value, size_t* size) {
+    const char* p, *end = object->end;
+    size_t i = 0;
+    json_type type;
+    int ret, equal = false;
+    assert(object != NULL && object->json != NULL && *object->json == '{');
+    p = json_skip_whitespace(object->json + 1, end);
+    if (PEEK(p, end) != '}') {
+        for (; ; i++) {
+            if (PEEK(p, end) != '"')
+                return JSON_PARSE_MISS_KEY;
+            if (key) {
+                if ((ret = json_lazy_key(&p, end, key, klen, &equal)) != JSON_PARSE_OK)
+                    return ret;
+            }
+            else if ((p = json_skip_structural(p, end)) == NULL)
+                return JSON_PARSE_MISS_QUOTATION_MARK;
+            p = json_skip_whitespace(p, end);
+            if (PEEK(p, end) != ':')
+                return JSON_PARSE_MISS_COLON;
+            p = json_skip_whitespace(p + 1, end);
+            if ((ret = json_lazy_type(p, end, &type)) != JSON_PARSE_OK)
+                return ret;
+            if (equal) {
+                value->json = p;
+                value->end = end;
+                return JSON_PARSE_OK;
+            }
+            if ((p = json_skip_structural(p, end)) == NULL)
+                return JSON_PARSE_INVALID_VALUE;
+            p = json_skip_whitespace(p, end);
+            if (PEEK(p, end) == ',')
+                p = json_skip_whitespace(p + 1, end);
+            else if (PEEK(p, end) == '}')
+                break;
+            else
+                return JSON_PARSE_MISS_COMMA_OR_CURLY_BRACKET;
+        }
+        i++;
+    }
+    if (value)
+        value->json = NULL;
+    if (size)
+        *size = i;
+    return JSON_PARSE_OK;
+}
+
+int json_lazy_find_object_value(const json_lazy* object, const char* key, size_t klen, json_lazy* value) {
+    assert(value != NULL && (key != NULL || klen == 0));
+    return json_lazy_object(object, key ? key : "", klen, value, NULL);
+}
+
+int json_lazy_get_object_size(const json_lazy* object, size_t* size) {
+    assert(size != NULL);
+    return json_lazy_object(object, NULL, 0, NULL, size);
+}
+
+/* JSON Pointer (RFC 6901): 编译时拆分并反转义各段, 之后可反复求值 */
+json_pointer* json_pointer_compile(const char* path, size_t len) {
+    json_pointer* pointer;
+    size_t count = 0;
+    char* d;
+    assert(path != NULL || len == 0);
+    if (len > 0 && path[0] != '/')
+        return NULL;
+    for (size_t i = 0; i < len; i++) {
+        if (path[i] == '/')
+            count++;
+        else if (path[i] == '~' && (i + 1 == len || (path[i + 1] != '0' && path[i + 1] != '1')))
+            return NULL;
+    }
+    /* 段数组和反转义后的字符串放在同一块内存中, 反转义不会变长 */
+    pointer = (json_pointer*)malloc(sizeof(json_pointer) + count * sizeof(json_pointer_token) + len);
+    pointer->count = count;
+    pointer->tokens = (json_pointer_token*)(pointer + 1);
+    d = (char*)(pointer->tokens + count);
+    for (size_t i = 0, k = 0; k < count; k++) {
+        json_pointer_token* t = &pointer->tokens[k];
+        t->key = d;
+        for (i++; i < len && path[i] != '/'; i++) {
+            if (path[i] == '~')
+                *d++ = path[++i] == '0' ? '~' : '/';
+            else
+                *d++ = path[i];
+        }
+        t->klen = d - t->key;
+        /* "0" 或不以 0 开头的数字; "-" 指向末尾之后, 总是不存在 */
+        t->index = JSON_KEY_NOT_EXIST;
+        if (t->klen > 0 && t->klen < 20 && (t->klen == 1 || t->key[0] != '0')) {
+            size_t n = 0, j;
+            for (j = 0; j < t->klen && ISDIGIT(t->key[j]); j++)
+                n = n * 10 + (t->key[j] - '0');
+            if (j == t->klen)
+                t->index = n;
+        }
+    }
+    return pointer;
+}
+
+void json_pointer_free(json_pointer* pointer) {
+    free(pointer);
+}
+
+json_value* json_pointer_get(const json_pointer* pointer, const json_value* value) {
+    assert(pointer != NULL && value != NULL);
+    for (size_t k = 0; k < pointer->count && value; k++) {
+        const json_pointer_token* t = &pointer->tokens[k];
+        if (value->type == JSON_OBJECT)
+            value = json_find_object_value(value, t->key, t->klen);
+        else if (value->type == JSON_ARRAY && t->index < value->size)
+            value = &value->ele[t->index];
+        else
+            value = NULL;
+    }
+    return (json_value*)value;
+}
+
+/* 沿路径只跳过不相关的兄弟节点, 不解析其它子树 */
+int json_pointer_get_lazy(const json_pointer* pointer, const json_lazy* lazy, json_lazy* result) {
+    json_lazy cur;
+    int ret;
+    assert(pointer != NULL && lazy != NULL && result != NULL);
+    cur = *lazy;
+    for (size_t k = 0; k < pointer->count && cur.json; k++) {
+        const json_pointer_token* t = &pointer->tokens[k];
+        switch (json_lazy_get_type(&cur)) {
+            case JSON_OBJECT:
+                ret = json_lazy_find_object_value(&cur, t->key, t->klen, &cur);
+                break;
+            case JSON_ARRAY:
+                if (t->index != JSON_KEY_NOT_EXIST) {
+                    ret = json_lazy_get_array_element(&cur, t->index, &cur);
+                    break;
+                }
+                /* fall through */
+            default:
+                cur.json = NULL;
+                ret = JSON_PARSE_OK;
+        }
+        if (ret != JSON_PARSE_OK)
+            return ret;
+    }
+    *result = cur;
+    return JSON_PARSE_OK;
+}
+
+json_value* json_pointer_find(const json_value* value, const char* path, size_t len) {
+    json_pointer* pointer = json_pointer_compile(path, len);
+    json_value* ret = pointer ? json_pointer_get(pointer, value) : NULL;
+    json_pointer_free(pointer);
+    return ret;
+}
+
+int json_parse_projected(json_value* value, const char* json, size_t len, json_pointer* const* paths, size_t count) {
+    json_context context;
+    struct json_projection proj;
+    size_t buffer[16];
+    int ret, keep = JSON_PROJECT_PATH;
+    assert(value != NULL && (json != NULL || len == 0) && (paths != NULL || count == 0));
+    json_context_init(&context, json, len);
+    proj.paths = paths;
+    proj.count = count;
+    proj.matched = count <= sizeof(buffer) / sizeof(buffer[0]) ? buffer : (size_t*)malloc(count * sizeof(size_t));
+    proj.depth = 0;
+    for (size_t i = 0; i < count; i++) {
+        proj.matched[i] = 0;
+        if (paths[i]->count == 0)
+            keep = JSON_PROJECT_ALL; /* "" 指向根, 即整个文档 */
+    }
+    context.projection = keep == JSON_PROJECT_ALL ? NULL : &proj;
+    json_init(value);
+    json_parse_whitespace(&context);
+    /* 根为标量时不可能在路径中途, 校验后得到 null */
+    switch (PEEK(context.json, context.end)) {
+        case '[': case '{': ret = json_parse_value(&context, value); break;
+        default: ret = context.projection ? json_skip_value(&context) : json_parse_value(&context, value);
+    }
+    if (ret == JSON_PARSE_OK) {
+        json_parse_whitespace(&context);
+        if (context.json != context.end) {
+            json_free(value);
+            ret = JSON_PARSE_ROOT_NOT_SINGULAR;
+        }
+    }
+    if (proj.matched != buffer)
+        free(proj.matched);
+    free(context.stack);
+    return ret;
+}
@@ -2,21 +2,26 @@
 #define JSON_H__
 
 #include <stddef.h> /* size_t */
+#include <stdint.h> /* int64_t */
+#include <stdio.h>  /* FILE */
 
 typedef enum { JSON_NULL, JSON_FALSE, JSON_TRUE, JSON_NUMBER, JSON_STRING, JSON_ARRAY, JSON_OBJECT } json_type;
 
 typedef struct json_value json_value;
 typedef struct json_member json_member;
 /*
-  ----------------------
-  | ele  | size |      |
-  |--------------      |
-  | str  | len  | type |
-  |--------------      |
-  |   double    |      |
-  ----------------------
+  ------------------------------
+  | ele  | size |      |       |
+  |--------------      |       |
+  | str  | len  | type | flags |
+  |--------------      |       |
+  | double/i64  |      |       |
+  ------------------------------
 */
 
+#define JSON_FLAG_INT64 0x1 /* JSON_NUMBER 以 i64 精确保存整数 */
+#define JSON_FLAG_INDEXED 0x2 /* JSON_OBJECT 的 mem 之后附带键的哈希索引 */
+
 struct json_value {
     union {
         struct {
@@ -32,8 +37,10 @@ struct json_value {
             size_t len;
         };
         double num;
+        int64_t i64;
     };
     json_type type;
+    unsigned flags; /* JSON_FLAG_* */
 };
 
 struct json_member {
@@ -42,6 +49,13 @@ struct json_member {
     json_value value; /* member value */
 };
 
+/* 区域分配器: 一个文档的所有节点/键/字符串都从少数几个大块中分配, 一次性释放 */
+typedef struct json_arena json_arena;
+struct json_arena {
+    struct json_arena_chunk* chunk; /* current (largest) chunk, linked to older ones */
+    size_t used; /* bytes used in current chunk */
+};
+
 enum {
     JSON_PARSE_OK = 0,
     JSON_PARSE_EXPECT_VALUE,
@@ -58,12 +72,90 @@ enum {
     JSON_PARSE_MISS_COLON,
     JSON_PARSE_MISS_COMMA_OR_CURLY_BRACKET,
     JSON_STRINGIFY_OK,
-    JSON_PARSE_STRINGIFY_INIT_SIZE
+    JSON_PARSE_HANDLER_ABORT, /* SAX 回调返回非 0 */
+    JSON_STRINGIFY_WRITE_ERROR, /* sink 返回非 0 */
+    JSON_STRINGIFY_BUFFER_TOO_SMALL,
+    JSON_PARSE_FILE_ERROR, /* 无法打开或读取文件 */
+    JSON_PARSE_TOO_LARGE, /* 超出紧凑格式 32 位下标的范围 */
+    JSON_PARSE_END, /* json_ndjson_next() 没有更多记录 */
 };
 
-#define json_init(value)    do { (value)->type = JSON_NULL; } while(0)
+/* json_stringify() 输出缓冲区的初始大小, 不是错误码 */
+#define JSON_PARSE_STRINGIFY_INIT_SIZE 15
+
+#define json_init(value)    do { (value)->type = JSON_NULL; (value)->flags = 0; } while(0)
 
 int json_parse(json_value* value, const char* json);
+/* json 不需要以 '\0' 结尾, 只读取 [json, json + len) */
+int json_parse_n(json_value* value, const char* json, size_t len);
+/* 只校验语法, 不构建 json_value, 错误码与 json_parse_n() 相同; 除超长的数字外不分配内存 */
+int json_validate(const char* json, size_t len);
+/* 解析整个文件, 普通文件经 mmap() 读取, 其它输入 (管道等) 退回 read() */
+int json_parse_file(json_value* value, const char* path);
+/* 根为大数组时用 threads 个线程 (0 为 CPU 数) 分段并行解析各元素; 结果和错误码与 json_parse_n() 相同 */
+int json_parse_parallel(json_value* value, const char* json, size_t len, unsigned threads);
+/* 两阶段解析: 先用 SIMD 建立所有 token 位置的结构索引, 再按索引构建 json_value; 结果和错误码与 json_parse_n() 相同 */
+int json_parse_indexed(json_value* value, const char* json, size_t len);
+
+void json_arena_init(json_arena* arena);
+void json_arena_reset(json_arena* arena);
+void json_arena_free(json_arena* arena);
+/* value 的内存属于 arena, 不要对其调用 json_free() */
+int json_parse_arena(json_arena* arena, json_value* value, const char* json);
+/* 原地解析: 字符串和键在 json 中原地反转义并以 '\0' 结尾, 直接指向 json; 解析后 json 内容被改写 */
+/* 数组/对象从 arena 分配, json 和 arena 都需要比 value 活得久 */
+int json_parse_insitu(json_arena* arena, json_value* value, char* json, size_t len);
+
+/* 可复用的解析/输出上下文, 内部的栈在调用之间保留; 同一时刻只能被一个线程使用 */
+typedef struct json_context json_context;
+json_context* json_context_create(void);
+void json_context_reset(json_context* context);
+void json_context_destroy(json_context* context);
+int json_context_parse(json_context* context, json_value* value, const char* json, size_t len);
+/* json 指向 context 内部的缓冲区 (以 '\0' 结尾), 在下一次使用 context 之前有效, 不要 free() */
+int json_context_stringify(json_context* context, const json_value* value, const char** json, size_t* length);
+
+/* NDJSON / JSON Lines: 每行一个文档, 空白行被跳过 */
+/* 解析 *json 开始的下一条记录并把 *json 移到该行之后; 没有更多记录时返回 JSON_PARSE_END */
+int json_ndjson_next(json_context* context, json_value* value, const char** json, const char* end);
+
+typedef struct {
+    json_value value; /* 出错时为 null */
+    int error;        /* 该行的解析结果 */
+    size_t offset;    /* 行在输入中的位置和长度 */
+    size_t length;
+} json_ndjson_record;
+
+/* 按行切分后用 threads 个线程并行解析 (0 为 CPU 数), 每个线程一个 json_context; 记录按输入顺序排列 */
+/* 返回记录数, *records 需用 json_ndjson_free() 释放 */
+size_t json_parse_ndjson(const char* json, size_t len, json_ndjson_record** records, unsigned threads);
+void json_ndjson_free(json_ndjson_record* records, size_t count);
+
+/* SAX 事件回调: 返回 0 继续, 非 0 则中止解析并返回 JSON_PARSE_HANDLER_ABORT; 不关心的事件可以为 NULL */
+/* 字符串/键只在回调期间有效; int64 为 NULL 时整数也经 number 回调 */
+typedef struct {
+    int (*null)(void* user);
+    int (*boolean)(void* user, int boolean);
+    int (*number)(void* user, double number);
+    int (*int64)(void* user, int64_t number);
+    int (*string)(void* user, const char* str, size_t len);
+    int (*start_object)(void* user);
+    int (*key)(void* user, const char* str, size_t len);
+    int (*end_object)(void* user, size_t size);
+    int (*start_array)(void* user);
+    int (*end_array)(void* user, size_t size);
+} json_handler;
+
+/* 不构建 json_value, 内存占用只与嵌套深度和最长的字符串有关; 出错前已发出的事件不会撤回 */
+int json_parse_sax(const json_handler* handler, void* user, const char* json, size_t len);
+
+/* 增量解析: 输入可以在任意字节处分块, 依次 feed(), 最后 finish() 得到与 json_parse() 相同的结果和错误码 */
+/* feed() 出错后忽略之后的输入并返回同一错误; finish() 之后 parser 可用于下一个文档 */
+typedef struct json_parser json_parser;
+json_parser* json_parser_create(void);
+int json_parser_feed(json_parser* parser, const char* chunk, size_t len);
+int json_parser_finish(json_parser* parser, json_value* value);
+void json_parser_destroy(json_parser* parser);
 
 void json_free(json_value* value);
 
@@ -77,6 +169,11 @@ void json_set_boolean(json_value* value, int boolean);
 double json_get_number(const json_value* value);
 void json_set_number(json_value* value, double number);
 
+/* 没有小数和指数且在 int64_t 范围内的数字解析为整数, 不经过 double */
+int json_is_int64(const json_value* value);
+int64_t json_get_int64(const json_value* value);
+void json_set_int64(json_value* value, int64_t number);
+
 const char* json_get_string(const json_value* value);
 size_t json_get_string_length(const json_value* value);
 void json_set_string(json_value* value, const char* str, size_t len);
@@ -89,6 +186,104 @@ const char* json_get_object_key(const json_value* value, size_t index);
 size_t json_get_object_key_length(const json_value* value, size_t index);
 json_value* json_get_object_value(const json_value* value, size_t index);
 
+#define JSON_KEY_NOT_EXIST ((size_t)-1)
+/* 成员数达到 JSON_OBJECT_INDEX_THRESHOLD 的对象在解析时建立哈希索引, 查找为 O(1); 键重复时返回第一个 */
+size_t json_find_object_index(const json_value* value, const char* key, size_t klen);
+json_value* json_find_object_value(const json_value* value, const char* key, size_t klen);
+
 int json_stringify(const json_value* value, char** json, size_t* length);
 
+/* json_stringify() 输出的准确长度 (不含 '\0') */
+size_t json_stringify_size(const json_value* value);
+/* 写入调用方的缓冲区, 不分配内存; cap 至少为 json_stringify_size() + 1, 否则返回 JSON_STRINGIFY_BUFFER_TOO_SMALL */
+/* length 非 NULL 时总是写入所需长度 */
+int json_stringify_into(const json_value* value, char* buf, size_t cap, size_t* length);
+
+/* 输出分批交给 sink, 缓冲区大小固定为 JSON_SINK_BUFFER_SIZE; sink 成功返回 0, 非 0 时返回 JSON_STRINGIFY_WRITE_ERROR */
+typedef int (*json_write_fn)(void* user, const char* data, size_t len);
+int json_stringify_to_sink(const json_value* value, json_write_fn sink, void* user);
+int json_stringify_to_file(const json_value* value, FILE* fp);
+int json_stringify_to_fd(const json_value* value, int fd);
+
+/* 流式输出: 按顺序调用 begin/key/值/end, 不构建 json_value, 转义规则与 json_stringify() 相同 */
+/* 对象中每个值之前先调用 json_writer_key(); 调用顺序由调用方保证 */
+typedef struct json_writer json_writer;
+json_writer* json_writer_create(void);
+void json_writer_null(json_writer* writer);
+void json_writer_boolean(json_writer* writer, int boolean);
+void json_writer_number(json_writer* writer, double number);
+void json_writer_int64(json_writer* writer, int64_t number);
+void json_writer_string(json_writer* writer, const char* str, size_t len);
+void json_writer_key(json_writer* writer, const char* key, size_t klen);
+void json_writer_begin_array(json_writer* writer);
+void json_writer_end_array(json_writer* writer);
+void json_writer_begin_object(json_writer* writer);
+void json_writer_end_object(json_writer* writer);
+int json_writer_finish(json_writer* writer, char** json, size_t* length);
+void json_writer_destroy(json_writer* writer);
+
+/* 紧凑只读格式: 每个节点 16 字节, 全部节点和字符串在一块连续内存中, 短字符串内联, 相同的键只存一份 */
+/* 节点指针在 json_tape_free() 之前有效; 节点数和字符串池都不能超过 4G */
+typedef struct json_tape json_tape;
+typedef struct json_node json_node;
+int json_parse_tape(json_tape** tape, const char* json, size_t len);
+json_tape* json_tape_from_value(const json_value* value);
+void json_tape_free(json_tape* tape);
+size_t json_tape_size(const json_tape* tape); /* 占用的字节数 */
+const json_node* json_tape_root(const json_tape* tape);
+
+json_type json_tape_get_type(const json_node* node);
+double json_tape_get_number(const json_node* node);
+int json_tape_is_int64(const json_node* node);
+int64_t json_tape_get_int64(const json_node* node);
+const char* json_tape_get_string(const json_tape* tape, const json_node* node);
+size_t json_tape_get_string_length(const json_node* node);
+size_t json_tape_get_array_size(const json_node* node);
+const json_node* json_tape_get_array_element(const json_tape* tape, const json_node* node, size_t index);
+size_t json_tape_get_object_size(const json_node* node);
+const char* json_tape_get_object_key(const json_tape* tape, const json_node* node, size_t index);
+size_t json_tape_get_object_key_length(const json_tape* tape, const json_node* node, size_t index);
+const json_node* json_tape_get_object_value(const json_tape* tape, const json_node* node, size_t index);
+const json_node* json_tape_find_object_value(const json_tape* tape, const json_node* node, const char* key, size_t klen);
+
+/* 惰性解析: 只定位值的起始位置, 访问子元素时跳过不需要的部分, 取值时才解析和检查 */
+/* 不检查根之后的内容; 输入需要比 json_lazy 活得久 */
+typedef struct {
+    const char* json; /* 值的第一个字符 */
+    const char* end;  /* 文档结尾 */
+} json_lazy;
+
+/* 成功返回的 json_lazy 都停在合法的值开头 (首字符为 n f t " [ { - 或数字), 否则返回与 json_parse_n() 相同的错误码 */
+int json_lazy_parse(json_lazy* lazy, const char* json, size_t len);
+/* 只由首字符决定, 值本身 (如 "tru"、"1x") 的错误在 json_lazy_get_value() 时才报告 */
+json_type json_lazy_get_type(const json_lazy* lazy);
+/* 解析出完整的 json_value, 需要 json_free(); 值之后紧跟的不是空白、',' 或右括号时返回 JSON_PARSE_INVALID_VALUE */
+int json_lazy_get_value(const json_lazy* lazy, json_value* value);
+/* 下标越界或键不存在时返回 JSON_PARSE_OK 且 element->json / value->json 为 NULL; 键重复时返回第一个 */
+int json_lazy_get_array_element(const json_lazy* array, size_t index, json_lazy* element);
+int json_lazy_get_array_size(const json_lazy* array, size_t* size);
+int json_lazy_find_object_value(const json_lazy* object, const char* key, size_t klen, json_lazy* value);
+int json_lazy_get_object_size(const json_lazy* object, size_t* size);
+
+/* 结构化跳过 json 开头 (可有空白) 的一个值, 返回其结束处的偏移; 容器内 SIMD 按块数括号, 不分配内存 */
+/* 只跟踪字符串和括号深度, 不检查其余文法, 内层括号不检查 '[' ']' 与 '{' '}' 是否配对 */
+/* 字符串或容器未结束、最外层括号不配对、括号多余或没有值 (包括以 ',' ':' 开头) 时返回 0 */
+size_t json_skip(const char* json, size_t len);
+
+/* JSON Pointer (RFC 6901), 如 "/a/b~1c/3"; 空串指向根 */
+/* 编译一次可反复求值; 路径不以 '/' 开头或含非法的 '~' 转义时返回 NULL */
+typedef struct json_pointer json_pointer;
+json_pointer* json_pointer_compile(const char* path, size_t len);
+void json_pointer_free(json_pointer* pointer);
+/* 不存在时返回 NULL; 对象查找经过 json_find_object_value() */
+json_value* json_pointer_get(const json_pointer* pointer, const json_value* value);
+/* 在惰性文档上求值, 只跳过路径之外的兄弟节点; 不存在时 result->json 为 NULL */
+int json_pointer_get_lazy(const json_pointer* pointer, const json_lazy* lazy, json_lazy* result);
+/* 编译并求值一次 */
+json_value* json_pointer_find(const json_value* value, const char* path, size_t len);
+/* 投影解析: 只构建 paths 经过的容器和路径终点的完整子树, 其它值只校验语法, 不分配内存 */
+/* 跳过的成员不出现在对象中, 跳过的数组元素留作 null 以保持下标; 数组中的 "*" 段匹配所有元素 */
+/* 错误码与 json_parse_n() 相同 */
+int json_parse_projected(json_value* value, const char* json, size_t len, json_pointer* const* paths, size_t count);
+
 #endif /* JSON_H__ */
@@ -8,6 +8,15 @@
 #include <string.h>
 #include "json.h"
 
+/* 解析相关的测试分别用 json_parse() 和 json_parse_indexed() 各运行一遍, 见 main() */
+static int parse_indexed = 0;
+
+static int test_json_parse(json_value* value, const char* json) {
+    return parse_indexed ? json_parse_indexed(value, json, strlen(json)) : json_parse(value, json);
+}
+
+#define json_parse test_json_parse
+
 static int main_ret = 0;
 static int test_count = 0;
 static int test_pass = 0;
@@ -24,6 +33,7 @@ static int test_pass = 0;
     } while(0)
 
 #define EXPECT_EQ_INT(expect, actual) EXPECT_EQ_BASE((expect) == (actual), expect, actual, "%d")
+#define EXPECT_EQ_INT64(expect, actual) EXPECT_EQ_BASE((expect) == (actual), (long long)(expect), (long long)(actual), "%lld")
 #define EXPECT_EQ_DOUBLE(expect, actual) EXPECT_EQ_BASE((expect) == (actual), expect, actual, "%.17g");
 #define EXPECT_EQ_STRING(expect, actual, length) EXPECT_EQ_BASE(sizeof(expect) - 1 == (length) && memcmp(expect, actual, length) == 0, expect, actual, "%s")
 #define EXPECT_TRUE(actual) EXPECT_EQ_BASE((actual) != 0, "true", "false", "%s")
@@ -61,6 +71,7 @@ static void test_parse_true() {
         json_value value;\
         json_init(&value);\
         EXPECT_EQ_INT(JSON_PARSE_OK, json_parse(&value, json));\
+        EXPECT_EQ_INT(JSON_PARSE_OK, json_validate(json, strlen(json)));\
         EXPECT_EQ_INT(JSON_NUMBER, json_get_type(&value));\
         EXPECT_EQ_DOUBLE(expect, json_get_number(&value));\
         json_free(&value);\
@@ -96,6 +107,51 @@ static void test_parse_number() {
     TEST_NUMBER(-2.2250738585072014e-308, "-2.2250738585072014e-308");
     TEST_NUMBER( 1.7976931348623157e+308, "1.7976931348623157e+308");  /* Max double */
     TEST_NUMBER(-1.7976931348623157e+308, "-1.7976931348623157e+308");
+
+    TEST_NUMBER(1e23, "1e23");
+    TEST_NUMBER(1.2345678901234567e-200, "1.2345678901234567e-200");
+    TEST_NUMBER(8.98846567431158e307, "8.98846567431158e307");
+    TEST_NUMBER(9007199254740992.0, "9007199254740993"); /* 2^53 + 1, ties to even */
+    TEST_NUMBER(3.141592653589793, "3.14159265358979323846264338327950288"); /* more than 19 digits */
+    TEST_NUMBER(0.0, "0.000000000000000000000000000000000000000000000000e-400");
+}
+
+#define TEST_INT64(expect, json)\
+    do {\
+        json_value value;\
+        json_init(&value);\
+        EXPECT_EQ_INT(JSON_PARSE_OK, json_parse(&value, json));\
+        EXPECT_EQ_INT(JSON_NUMBER, json_get_type(&value));\
+        EXPECT_TRUE(json_is_int64(&value));\
+        EXPECT_EQ_INT64(expect, json_get_int64(&value));\
+        json_free(&value);\
+    } while (0)
+
+static void test_parse_int64() {
+    TEST_INT64(0, "0");
+    TEST_INT64(123, "123");
+    TEST_INT64(-123, "-123");
+    TEST_INT64(9007199254740993LL, "9007199254740993"); /* 2^53 + 1, double 无法精确表示 */
+    TEST_INT64(1700000000123456789LL, "1700000000123456789");
+    TEST_INT64(INT64_MAX, "9223372036854775807");
+    TEST_INT64(INT64_MIN, "-9223372036854775808");
+
+    /* 以下仍为 double */
+    {
+        json_value value;
+        json_init(&value);
+        EXPECT_EQ_INT(JSON_PARSE_OK, json_parse(&value, "9223372036854775808"));
+        EXPECT_FALSE(json_is_int64(&value));
+        EXPECT_EQ_DOUBLE(9223372036854775808.0, json_get_number(&value));
+        EXPECT_EQ_INT(JSON_PARSE_OK, json_parse(&value, "-0"));
+        EXPECT_FALSE(json_is_int64(&value));
+        EXPECT_EQ_INT(JSON_PARSE_OK, json_parse(&value, "1.0"));
+        EXPECT_FALSE(json_is_int64(&value));
+        EXPECT_EQ_INT(JSON_PARSE_OK, json_parse(&value, "1e2"));
+        EXPECT_FALSE(json_is_int64(&value));
+        EXPECT_EQ_INT64(100, json_get_int64(&value));
+        json_free(&value);
+    }
 }
 
 #define TEST_STRING(expect, json)\
@@ -119,6 +175,9 @@ static void test_parse_string() {
     TEST_STRING("\xE2\x82\xAC", "\"\\u20AC\""); /* Euro sign U+20AC */
     TEST_STRING("\xF0\x9D\x84\x9E", "\"\\uD834\\uDD1E\"");  /* G clef sign U+1D11E */
     TEST_STRING("\xF0\x9D\x84\x9E", "\"\\ud834\\udd1e\"");  /* G clef sign U+1D11E */
+    /* 长字符串, 转义出现在 SIMD 块内外的不同位置 */
+    TEST_STRING("0123456789abcdef0123456789ABCDEF\"0123456789abcdef\n", "\"0123456789abcdef0123456789ABCDEF\\\"0123456789abcdef\\n\"");
+    TEST_STRING("The quick brown fox jumps over the lazy dog, \xE2\x82\xAC and the lazy dog sleeps", "\"The quick brown fox jumps over the lazy dog, \\u20AC and the lazy dog sleeps\"");
 }
 
 #if defined(_MSC_VER)
@@ -175,6 +234,13 @@ static void test_parse_object() {
     EXPECT_EQ_SIZE_T(0, json_get_object_size(&value));
     json_free(&value);
 
+    /* 超过 SIMD 宽度的空白 */
+    json_init(&value);
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_parse(&value, " {\n                                  \t\r\n} "));
+    EXPECT_EQ_INT(JSON_OBJECT, json_get_type(&value));
+    EXPECT_EQ_SIZE_T(0, json_get_object_size(&value));
+    json_free(&value);
+
     json_init(&value);
     EXPECT_EQ_INT(JSON_PARSE_OK, json_parse(&value,
         " { "
@@ -224,6 +290,679 @@ static void test_parse_object() {
     json_free(&value);
 }
 
+static void test_find_object() {
+    json_value value;
+    char json[1024], key[16];
+    size_t i, n = 0;
+
+    json_init(&value);
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_parse(&value, "{\"a\":1,\"b\":2,\"a\":3}"));
+    EXPECT_EQ_SIZE_T(0, json_find_object_index(&value, "a", 1));
+    EXPECT_EQ_SIZE_T(1, json_find_object_index(&value, "b", 1));
+    EXPECT_EQ_SIZE_T(JSON_KEY_NOT_EXIST, json_find_object_index(&value, "c", 1));
+    EXPECT_EQ_DOUBLE(2.0, json_get_number(json_find_object_value(&value, "b", 1)));
+    EXPECT_TRUE(json_find_object_value(&value, "ab", 2) == NULL);
+    json_free(&value);
+
+    /* 足够多的成员会建立哈希索引 */
+    json[n++] = '{';
+    for (i = 0; i < 40; i++)
+        n += sprintf(json + n, "%s\"key%d\":%d", i ? "," : "", (int)i, (int)i);
+    n += sprintf(json + n, ",\"key7\":-1}");
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_parse(&value, json));
+    EXPECT_EQ_SIZE_T(41, json_get_object_size(&value));
+    for (i = 0; i < 40; i++) {
+        size_t len = sprintf(key, "key%d", (int)i);
+        EXPECT_EQ_SIZE_T(i, json_find_object_index(&value, key, len));
+        EXPECT_EQ_DOUBLE((double)i, json_get_number(json_find_object_value(&value, key, len)));
+    }
+    EXPECT_EQ_SIZE_T(JSON_KEY_NOT_EXIST, json_find_object_index(&value, "key40", 5));
+    EXPECT_EQ_SIZE_T(JSON_KEY_NOT_EXIST, json_find_object_index(&value, "", 0));
+    json_free(&value);
+}
+
+/* 把 SAX 事件记录成文本 */
+typedef struct {
+    char buf[256];
+    size_t len;
+    int stop_at; /* 第几个事件返回非 0, 0 表示不中止 */
+    int count;
+} sax_trace;
+
+static int sax_append(void* user, const char* prefix, const char* s, size_t len) {
+    sax_trace* t = (sax_trace*)user;
+    t->len += sprintf(t->buf + t->len, "%s", prefix);
+    memcpy(t->buf + t->len, s, len);
+    t->len += len;
+    t->buf[t->len++] = ' ';
+    return ++t->count == t->stop_at;
+}
+
+static int sax_null(void* user) { return sax_append(user, "n", "", 0); }
+static int sax_boolean(void* user, int b) { return sax_append(user, b ? "t" : "f", "", 0); }
+static int sax_number(void* user, double d) { char s[32]; return sax_append(user, "d", s, sprintf(s, "%g", d)); }
+static int sax_int64(void* user, int64_t i) { char s[32]; return sax_append(user, "i", s, sprintf(s, "%lld", (long long)i)); }
+static int sax_string(void* user, const char* str, size_t len) { return sax_append(user, "s:", str, len); }
+static int sax_start_object(void* user) { return sax_append(user, "{", "", 0); }
+static int sax_key(void* user, const char* str, size_t len) { return sax_append(user, "k:", str, len); }
+static int sax_end_object(void* user, size_t size) { char s[32]; return sax_append(user, "}", s, sprintf(s, "%d", (int)size)); }
+static int sax_start_array(void* user) { return sax_append(user, "[", "", 0); }
+static int sax_end_array(void* user, size_t size) { char s[32]; return sax_append(user, "]", s, sprintf(s, "%d", (int)size)); }
+
+static const json_handler sax_handler = {
+    sax_null, sax_boolean, sax_number, sax_int64, sax_string,
+    sax_start_object, sax_key, sax_end_object, sax_start_array, sax_end_array
+};
+
+#define TEST_SAX(ret, expect, json, stop)\
+    do {\
+        sax_trace t;\
+        t.len = 0;\
+        t.count = 0;\
+        t.stop_at = stop;\
+        EXPECT_EQ_INT(ret, json_parse_sax(&sax_handler, &t, json, strlen(json)));\
+        EXPECT_EQ_STRING(expect, t.buf, t.len);\
+    } while(0)
+
+static void test_parse_sax() {
+    TEST_SAX(JSON_PARSE_OK, "n ", " null ", 0);
+    TEST_SAX(JSON_PARSE_OK, "[ i1 d2.5 s:a\tb t f ]5 ", "[1, 2.5, \"a\\tb\", true, false]", 0);
+    TEST_SAX(JSON_PARSE_OK, "{ k:a [ ]0 k:b { k:c n }1 }2 ", "{\"a\":[],\"b\":{\"c\":null}}", 0);
+    /* 出错前的事件已经发出 */
+    TEST_SAX(JSON_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, "[ i1 ", "[1 2]", 0);
+    TEST_SAX(JSON_PARSE_ROOT_NOT_SINGULAR, "t ", "true x", 0);
+    TEST_SAX(JSON_PARSE_INVALID_STRING_ESCAPE, "{ ", "{\"\\v\":1}", 0);
+    /* 回调中止 */
+    TEST_SAX(JSON_PARSE_HANDLER_ABORT, "[ i1 ", "[1, 2, 3]", 2);
+    {
+        json_handler h;
+        memset(&h, 0, sizeof(h));
+        EXPECT_EQ_INT(JSON_PARSE_OK, json_parse_sax(&h, NULL, "{\"a\":[1,\"b\",null]}", 18));
+    }
+}
+
+/* 在每个位置切成两块, 以及逐字节喂入, 结果都应与 json_parse() 一致 */
+static void test_incremental(json_parser* parser, const char* json) {
+    json_value expect, actual;
+    char* s1 = NULL, *s2;
+    size_t n = strlen(json), l1 = 0, l2;
+    int ret;
+    json_init(&expect);
+    ret = json_parse(&expect, json);
+    if (ret == JSON_PARSE_OK)
+        json_stringify(&expect, &s1, &l1);
+    for (size_t k = 0; k <= n + 1; k++) {
+        if (k <= n) {
+            json_parser_feed(parser, json, k);
+            json_parser_feed(parser, json + k, n - k);
+        }
+        else
+            for (size_t i = 0; i < n; i++)
+                json_parser_feed(parser, json + i, 1);
+        EXPECT_EQ_INT(ret, json_parser_finish(parser, &actual));
+        if (ret == JSON_PARSE_OK) {
+            json_stringify(&actual, &s2, &l2);
+            EXPECT_TRUE(l1 == l2 && memcmp(s1, s2, l1) == 0);
+            free(s2);
+        }
+        else
+            EXPECT_EQ_INT(JSON_NULL, json_get_type(&actual));
+        json_free(&actual);
+    }
+    json_free(&expect);
+    free(s1);
+}
+
+static void test_parse_incremental() {
+    static const char* docs[] = {
+        "null", " true ", "false", "-1.25e+10", "9223372036854775807", "\"\"",
+        "\"Hello\\nWorld \\\\\\\" \\u20AC \\uD834\\uDD1E\"",
+        "[ 1, [], {}, \"a\", [null, false, [true]] ]",
+        "{ \"n\" : null , \"a\":[1,2,{\"o\":{}}], \"s\\\"\" : \"x\\\\\"}",
+        "{\"a\":1,\"b\":2,\"c\":3,\"d\":4,\"e\":5,\"f\":6,\"g\":7,\"h\":8,\"i\":9,\"j\":10,\"k\":11,\"l\":12,\"m\":13,\"n\":14,\"o\":15,\"p\":16}",
+        /* 错误 */
+        "", " ", "nul", "?", "tru e", "0123", "1-2", "[1,]", "[\"a\", nul]", "1.", "1e", "-", "1e309",
+        "\"abc", "\"\\v\"", "\"\x01\"", "\"\\u12\"3", "\"\\uD800\"", "\"\\uDBFF\\u0000\"",
+        "[1", "[1}", "[1 2", "{", "{1:1}", "{\"a\"", "{\"a\" 1}", "{\"a\":", "{\"a\":1,", "{\"a\":1]",
+        "{\"a\":[1,{\"b\":\"c\"", "[[[[[]]]]] x", "{}{}", "nullx"
+    };
+    json_parser* parser = json_parser_create();
+    json_value value;
+    for (size_t i = 0; i < sizeof(docs) / sizeof(docs[0]); i++)
+        test_incremental(parser, docs[i]);
+
+    /* 出错后的输入被忽略, finish() 返回同一错误并复位 */
+    EXPECT_EQ_INT(JSON_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, json_parser_feed(parser, "[\"a\" \"b\"", 8));
+    EXPECT_EQ_INT(JSON_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, json_parser_feed(parser, "]", 1));
+    EXPECT_EQ_INT(JSON_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, json_parser_finish(parser, &value));
+    EXPECT_EQ_INT(JSON_NULL, json_get_type(&value));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_parser_feed(parser, "{\"k\":\"v", 7));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_parser_feed(parser, "\"}", 2));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_parser_finish(parser, &value));
+    EXPECT_EQ_STRING("v", json_get_string(json_find_object_value(&value, "k", 1)), json_get_string_length(json_find_object_value(&value, "k", 1)));
+    json_free(&value);
+
+    /* 未完成时销毁, 释放已解析的部分 */
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_parser_feed(parser, "[{\"a\":[\"x\"], \"b\":\"yyy", 21));
+    json_parser_destroy(parser);
+}
+
+static void test_parse_n() {
+    json_value value;
+    /* 只解析前 len 个字符, 之后的内容不可见 */
+    const char* json = "[12,\"abc\",true]345";
+
+    json_init(&value);
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_parse_n(&value, json, 15));
+    EXPECT_EQ_INT(JSON_ARRAY, json_get_type(&value));
+    EXPECT_EQ_SIZE_T(3, json_get_array_size(&value));
+    json_free(&value);
+
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_parse_n(&value, json + 1, 1));
+    EXPECT_EQ_DOUBLE(1.0, json_get_number(&value));
+    json_free(&value);
+
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_parse_n(&value, json + 16, 2));
+    EXPECT_EQ_DOUBLE(45.0, json_get_number(&value));
+    json_free(&value);
+
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_parse_n(&value, json + 4, 5));
+    EXPECT_EQ_STRING("abc", json_get_string(&value), json_get_string_length(&value));
+    json_free(&value);
+
+    EXPECT_EQ_INT(JSON_PARSE_EXPECT_VALUE, json_parse_n(&value, json, 0));
+    EXPECT_EQ_INT(JSON_PARSE_MISS_QUOTATION_MARK, json_parse_n(&value, json + 4, 4));
+    EXPECT_EQ_INT(JSON_PARSE_INVALID_VALUE, json_parse_n(&value, json + 10, 3));
+    EXPECT_EQ_INT(JSON_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, json_parse_n(&value, json, 14));
+    EXPECT_EQ_INT(JSON_PARSE_ROOT_NOT_SINGULAR, json_parse_n(&value, "1\0", 2));
+    EXPECT_EQ_INT(JSON_PARSE_INVALID_STRING_CHAR, json_parse_n(&value, "\"a\0b\"", 5));
+}
+
+static void test_parse_context() {
+    json_context* context = json_context_create();
+    json_value value;
+    const char* json;
+    size_t length;
+    char big[1024];
+
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ_INT(JSON_PARSE_OK, json_context_parse(context, &value, "[1,{\"a\":\"b\\n\"}]", 15));
+        EXPECT_EQ_SIZE_T(2, json_get_array_size(&value));
+        EXPECT_EQ_INT(JSON_STRINGIFY_OK, json_context_stringify(context, &value, &json, &length));
+        EXPECT_EQ_STRING("[1,{\"a\":\"b\\n\"}]", json, length);
+        EXPECT_EQ_INT('\0', json[length]);
+        json_free(&value);
+        EXPECT_EQ_INT(JSON_PARSE_MISS_COMMA_OR_CURLY_BRACKET, json_context_parse(context, &value, "{\"a\":[\"b\"]", 10));
+        EXPECT_EQ_INT(JSON_NULL, json_get_type(&value));
+    }
+
+    /* 栈增长之后 reset() 释放, 仍可继续使用 */
+    memset(big, 'x', sizeof(big));
+    big[0] = big[sizeof(big) - 1] = '"';
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_context_parse(context, &value, big, sizeof(big)));
+    EXPECT_EQ_SIZE_T(sizeof(big) - 2, json_get_string_length(&value));
+    json_free(&value);
+    json_context_reset(context);
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_context_parse(context, &value, "\"abc\"", 5));
+    EXPECT_EQ_STRING("abc", json_get_string(&value), json_get_string_length(&value));
+    json_free(&value);
+    json_context_destroy(context);
+}
+
+static void test_parse_file() {
+    const char* path = "json_test.tmp";
+    json_value value;
+    FILE* fp;
+
+    json_init(&value);
+    value.type = JSON_TRUE;
+    EXPECT_EQ_INT(JSON_PARSE_FILE_ERROR, json_parse_file(&value, "json_test.not.exist"));
+    EXPECT_EQ_INT(JSON_NULL, json_get_type(&value));
+
+    if ((fp = fopen(path, "wb")) == NULL)
+        return;
+    fputs(" {\"a\" : [1, \"x\"], \"b\" : null} \n", fp);
+    fclose(fp);
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_parse_file(&value, path));
+    EXPECT_EQ_INT(JSON_OBJECT, json_get_type(&value));
+    EXPECT_EQ_SIZE_T(2, json_get_array_size(json_find_object_value(&value, "a", 1)));
+    json_free(&value);
+
+    /* 空文件不能映射, 走 read() */
+    fp = fopen(path, "wb");
+    fclose(fp);
+    EXPECT_EQ_INT(JSON_PARSE_EXPECT_VALUE, json_parse_file(&value, path));
+    remove(path);
+}
+
+static void test_parse_ndjson() {
+    const char* json = "{\"id\":1}\n\n  [1, 2]\r\n\"a\\nb\"\n{\"id\":\n \t \ntrue";
+    const char* p = json, *end = json + strlen(json);
+    json_context* context = json_context_create();
+    json_ndjson_record* records;
+    json_value value;
+    char* big;
+    size_t n;
+    int ret;
+
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_ndjson_next(context, &value, &p, end));
+    EXPECT_EQ_INT(JSON_OBJECT, json_get_type(&value));
+    json_free(&value);
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_ndjson_next(context, &value, &p, end));
+    EXPECT_EQ_SIZE_T(2, json_get_array_size(&value));
+    json_free(&value);
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_ndjson_next(context, &value, &p, end));
+    EXPECT_EQ_STRING("a\nb", json_get_string(&value), json_get_string_length(&value));
+    json_free(&value);
+    /* 出错的行不影响之后的记录 */
+    EXPECT_EQ_INT(JSON_PARSE_EXPECT_VALUE, json_ndjson_next(context, &value, &p, end));
+    EXPECT_TRUE(p != end);
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_ndjson_next(context, &value, &p, end));
+    EXPECT_EQ_INT(JSON_TRUE, json_get_type(&value));
+    EXPECT_EQ_INT(JSON_PARSE_END, json_ndjson_next(context, &value, &p, end));
+    EXPECT_TRUE(p == end);
+    EXPECT_EQ_INT(JSON_NULL, json_get_type(&value));
+    /* 截断的记录和结束可以区分, 循环读到 JSON_PARSE_END 不会漏掉之后的记录 */
+    p = "{\"id\":\n\n 1 \n";
+    end = p + strlen(p);
+    n = 0;
+    while ((ret = json_ndjson_next(context, &value, &p, end)) != JSON_PARSE_END) {
+        EXPECT_EQ_INT(n == 0 ? JSON_PARSE_EXPECT_VALUE : JSON_PARSE_OK, ret);
+        json_free(&value);
+        n++;
+    }
+    EXPECT_EQ_SIZE_T(2, n);
+    json_context_destroy(context);
+
+    n = json_parse_ndjson(json, strlen(json), &records, 1);
+    EXPECT_EQ_SIZE_T(5, n);
+    EXPECT_EQ_INT(JSON_PARSE_OK, records[0].error);
+    EXPECT_EQ_SIZE_T(10, records[1].offset);
+    EXPECT_EQ_INT(JSON_PARSE_EXPECT_VALUE, records[3].error);
+    EXPECT_EQ_INT(JSON_NULL, json_get_type(&records[3].value));
+    EXPECT_EQ_INT(JSON_TRUE, json_get_type(&records[4].value));
+    json_ndjson_free(records, n);
+
+    /* 多线程: 结果按输入顺序 */
+    big = (char*)malloc(10000 * 16);
+    p = big;
+    for (int i = 0; i < 10000; i++)
+        big += sprintf(big, i % 1000 == 999 ? "[%d,]\n" : "[%d]\n", i);
+    n = json_parse_ndjson(p, big - p, &records, 4);
+    EXPECT_EQ_SIZE_T(10000, n);
+    {
+        size_t ok = 0;
+        for (size_t i = 0; i < n; i++)
+            ok += i % 1000 == 999 ? records[i].error == JSON_PARSE_INVALID_VALUE :
+                records[i].error == JSON_PARSE_OK && json_get_number(json_get_array_element(&records[i].value, 0)) == (double)i;
+        EXPECT_EQ_SIZE_T(n, ok);
+    }
+    json_ndjson_free(records, n);
+    free((char*)p);
+}
+
+static void test_parse_parallel() {
+    size_t n = 20000, len;
+    char* json = (char*)malloc(n * 64), *p = json;
+    json_value expect, actual;
+    char* s1, *s2;
+    size_t l1, l2;
+
+    p += sprintf(p, " [ ");
+    for (size_t i = 0; i < n; i++)
+        p += sprintf(p, i % 3 == 0 ? "{\"id\":%d,\"s\":\"a,]\\\"b\",\"a\":[1,[2]]}, " : i % 3 == 1 ? "[%d,\"}\"], " : "%d.5, ", (int)i);
+    p += sprintf(p, "null ] \n");
+    len = p - json;
+
+    json_init(&expect);
+    json_init(&actual);
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_parse_n(&expect, json, len));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_parse_parallel(&actual, json, len, 4));
+    EXPECT_EQ_SIZE_T(n + 1, json_get_array_size(&actual));
+    json_stringify(&expect, &s1, &l1);
+    json_stringify(&actual, &s2, &l2);
+    EXPECT_TRUE(l1 == l2 && memcmp(s1, s2, l1) == 0);
+    free(s1);
+    free(s2);
+    json_free(&expect);
+    json_free(&actual);
+
+    /* 出错时错误码与串行解析一致 */
+    {
+        char c = json[len / 2 + 10];
+        json[len / 2 + 10] = '}';
+        EXPECT_EQ_INT(json_parse_n(&expect, json, len), json_parse_parallel(&actual, json, len, 4));
+        EXPECT_EQ_INT(JSON_NULL, json_get_type(&actual));
+        json[len / 2 + 10] = c;
+    }
+    /* 根数组以 '}' 结尾 */
+    EXPECT_EQ_INT(']', json[len - 3]);
+    json[len - 3] = '}';
+    EXPECT_EQ_INT(JSON_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, json_parse_parallel(&actual, json, len, 4));
+    EXPECT_EQ_INT(JSON_NULL, json_get_type(&actual));
+    json[len - 3] = ']';
+    memcpy(json + len - 4, "]]", 2);
+    EXPECT_EQ_INT(JSON_PARSE_ROOT_NOT_SINGULAR, json_parse_parallel(&actual, json, len, 4));
+    EXPECT_EQ_INT(JSON_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, json_parse_parallel(&actual, json, len - 4, 4));
+    free(json);
+
+    /* 小文档或根不是数组时串行解析 */
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_parse_parallel(&actual, "[1,2]", 5, 4));
+    EXPECT_EQ_SIZE_T(2, json_get_array_size(&actual));
+    json_free(&actual);
+    EXPECT_EQ_INT(JSON_PARSE_INVALID_VALUE, json_parse_parallel(&actual, "[1,]", 4, 0));
+}
+
+/* 转义、字符串和数字落在 64 字节块边界的各个位置 */
+static void test_parse_indexed() {
+    static const char* items[] = {
+        "\"a\\\\\\\"b\"", "\"\\\\\"", "12345.678e-3", "\"\\u00e9[]{}:,\"", "true", "[[],{}]", "{\"k\\\"\":null}",
+        /* 错误 */
+        "\"a\\\"", "1 2", "tru", "\"\\x\"", "[1}", "\"a\"b", "1\"a\""
+    };
+    char json[256];
+    json_value expect, actual;
+    for (size_t k = 0; k < sizeof(items) / sizeof(items[0]); k++) {
+        for (int off = 0; off < 140; off++) {
+            int n = sprintf(json, "[%*s%s , %s]", off, "", items[k], items[k]);
+            char* s1, *s2;
+            size_t l1, l2;
+            int ret = json_parse_n(&expect, json, n);
+            EXPECT_EQ_INT(ret, json_parse_indexed(&actual, json, n));
+            if (ret == JSON_PARSE_OK) {
+                json_stringify(&expect, &s1, &l1);
+                json_stringify(&actual, &s2, &l2);
+                EXPECT_TRUE(l1 == l2 && memcmp(s1, s2, l1) == 0);
+                free(s1);
+                free(s2);
+                json_free(&expect);
+                json_free(&actual);
+            }
+        }
+    }
+}
+
+static void test_parse_tape() {
+    json_tape* tape;
+    const json_node* root, *a, *o;
+    const char* json = "{\"id\":42,\"name\":\"short\",\"text\":\"a string longer than eleven bytes\","
+        "\"list\":[1.5,true,null,[],{}],\"children\":[{\"a_long_key_name\":1},{\"a_long_key_name\":2}]}";
+
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_parse_tape(&tape, json, strlen(json)));
+    root = json_tape_root(tape);
+    EXPECT_EQ_INT(JSON_OBJECT, json_tape_get_type(root));
+    EXPECT_EQ_SIZE_T(5, json_tape_get_object_size(root));
+    EXPECT_EQ_STRING("name", json_tape_get_object_key(tape, root, 1), json_tape_get_object_key_length(tape, root, 1));
+    EXPECT_TRUE(json_tape_is_int64(json_tape_get_object_value(tape, root, 0)));
+    EXPECT_EQ_INT64(42, json_tape_get_int64(json_tape_get_object_value(tape, root, 0)));
+    EXPECT_EQ_STRING("short", json_tape_get_string(tape, json_tape_find_object_value(tape, root, "name", 4)),
+        json_tape_get_string_length(json_tape_find_object_value(tape, root, "name", 4)));
+    EXPECT_EQ_STRING("a string longer than eleven bytes", json_tape_get_string(tape, json_tape_find_object_value(tape, root, "text", 4)),
+        json_tape_get_string_length(json_tape_find_object_value(tape, root, "text", 4)));
+    EXPECT_TRUE(json_tape_find_object_value(tape, root, "nothing", 7) == NULL);
+
+    a = json_tape_find_object_value(tape, root, "list", 4);
+    EXPECT_EQ_SIZE_T(5, json_tape_get_array_size(a));
+    EXPECT_EQ_DOUBLE(1.5, json_tape_get_number(json_tape_get_array_element(tape, a, 0)));
+    EXPECT_EQ_INT(JSON_TRUE, json_tape_get_type(json_tape_get_array_element(tape, a, 1)));
+    EXPECT_EQ_INT(JSON_NULL, json_tape_get_type(json_tape_get_array_element(tape, a, 2)));
+    EXPECT_EQ_SIZE_T(0, json_tape_get_array_size(json_tape_get_array_element(tape, a, 3)));
+    EXPECT_EQ_SIZE_T(0, json_tape_get_object_size(json_tape_get_array_element(tape, a, 4)));
+
+    /* 相同的长键只存一份 */
+    a = json_tape_find_object_value(tape, root, "children", 8);
+    o = json_tape_get_array_element(tape, a, 1);
+    EXPECT_EQ_INT64(2, json_tape_get_int64(json_tape_find_object_value(tape, o, "a_long_key_name", 15)));
+    EXPECT_TRUE(json_tape_get_object_key(tape, json_tape_get_array_element(tape, a, 0), 0) == json_tape_get_object_key(tape, o, 0));
+    json_tape_free(tape);
+
+    EXPECT_EQ_INT(JSON_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, json_parse_tape(&tape, "[1 2]", 5));
+    EXPECT_TRUE(tape == NULL);
+}
+
+static void test_parse_lazy() {
+    const char* json = " {\"header\":{\"route\":\"eu-1\",\"id\":7}, \"body\":[1,{\"x\":[\"]}\\\"\"]},\"\\u0061\",[[]],\"last\"],"
+        "\"k\\\"ey\":true, \"bad\":[1 2]} ";
+    json_lazy root, v, e;
+    json_value value;
+    size_t size;
+
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_parse(&root, json, strlen(json)));
+    EXPECT_EQ_INT(JSON_OBJECT, json_lazy_get_type(&root));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_get_object_size(&root, &size));
+    EXPECT_EQ_SIZE_T(4, size);
+
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_find_object_value(&root, "header", 6, &v));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_find_object_value(&v, "route", 5, &e));
+    EXPECT_EQ_INT(JSON_STRING, json_lazy_get_type(&e));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_get_value(&e, &value));
+    EXPECT_EQ_STRING("eu-1", json_get_string(&value), json_get_string_length(&value));
+    json_free(&value);
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_find_object_value(&v, "none", 4, &e));
+    EXPECT_TRUE(e.json == NULL);
+
+    /* 带转义的键, 跳过含括号和引号的字符串 */
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_find_object_value(&root, "k\"ey", 4, &v));
+    EXPECT_EQ_INT(JSON_TRUE, json_lazy_get_type(&v));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_find_object_value(&root, "body", 4, &v));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_get_array_size(&v, &size));
+    EXPECT_EQ_SIZE_T(5, size);
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_get_array_element(&v, 4, &e));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_get_value(&e, &value));
+    EXPECT_EQ_STRING("last", json_get_string(&value), json_get_string_length(&value));
+    json_free(&value);
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_get_array_element(&v, 1, &e));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_get_value(&e, &value));
+    EXPECT_EQ_INT(JSON_OBJECT, json_get_type(&value));
+    json_free(&value);
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_get_array_element(&v, 5, &e));
+    EXPECT_TRUE(e.json == NULL);
+
+    /* 错误在访问到时才报告 */
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_find_object_value(&root, "bad", 3, &v));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_get_array_element(&v, 0, &e));
+    EXPECT_EQ_INT(JSON_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, json_lazy_get_array_element(&v, 1, &e));
+    EXPECT_EQ_INT(JSON_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, json_lazy_get_value(&v, &value));
+    EXPECT_EQ_INT(JSON_PARSE_EXPECT_VALUE, json_lazy_parse(&root, "  ", 2));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_parse(&root, "{\"a\":[1,\"x", 10));
+    EXPECT_EQ_INT(JSON_PARSE_INVALID_VALUE, json_lazy_find_object_value(&root, "b", 1, &v));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_parse(&root, "{\"a\" 1}", 7));
+    EXPECT_EQ_INT(JSON_PARSE_MISS_COLON, json_lazy_find_object_value(&root, "a", 1, &v));
+
+    /* 缺少的元素/值与 json_parse_n() 报告相同的错误, 不会数出或返回不存在的元素 */
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_parse(&root, "[1,,2]", 6));
+    EXPECT_EQ_INT(JSON_PARSE_INVALID_VALUE, json_lazy_get_array_size(&root, &size));
+    EXPECT_EQ_INT(JSON_PARSE_INVALID_VALUE, json_lazy_get_array_element(&root, 1, &e));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_parse(&root, "[1,]", 4));
+    EXPECT_EQ_INT(JSON_PARSE_INVALID_VALUE, json_lazy_get_array_size(&root, &size));
+    EXPECT_EQ_INT(JSON_PARSE_INVALID_VALUE, json_lazy_get_array_element(&root, 1, &e));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_parse(&root, "[,1]", 4));
+    EXPECT_EQ_INT(JSON_PARSE_INVALID_VALUE, json_lazy_get_array_element(&root, 0, &e));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_parse(&root, "[1, ", 4));
+    EXPECT_EQ_INT(JSON_PARSE_EXPECT_VALUE, json_lazy_get_array_element(&root, 1, &e));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_parse(&root, "[x]", 3));
+    EXPECT_EQ_INT(JSON_PARSE_INVALID_VALUE, json_lazy_get_array_element(&root, 0, &e));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_parse(&root, "{\"a\":,\"b\":1}", 13));
+    EXPECT_EQ_INT(JSON_PARSE_INVALID_VALUE, json_lazy_find_object_value(&root, "b", 1, &v));
+    EXPECT_EQ_INT(JSON_PARSE_INVALID_VALUE, json_lazy_get_object_size(&root, &size));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_parse(&root, "{\"a\":}", 6));
+    EXPECT_EQ_INT(JSON_PARSE_INVALID_VALUE, json_lazy_find_object_value(&root, "a", 1, &v));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_parse(&root, "{\"a\":[}]}", 9));
+    EXPECT_EQ_INT(JSON_PARSE_INVALID_VALUE, json_lazy_get_object_size(&root, &size));
+    EXPECT_EQ_INT(JSON_PARSE_INVALID_VALUE, json_lazy_parse(&root, " ]", 2));
+    EXPECT_TRUE(root.json == NULL);
+    EXPECT_EQ_INT(JSON_PARSE_INVALID_VALUE, json_lazy_parse(&root, ",", 1));
+    /* 类型只由首字符决定 */
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_parse(&root, "[-1,tru]", 8));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_get_array_element(&root, 0, &e));
+    EXPECT_EQ_INT(JSON_NUMBER, json_lazy_get_type(&e));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_get_array_element(&root, 1, &e));
+    EXPECT_EQ_INT(JSON_TRUE, json_lazy_get_type(&e));
+    EXPECT_EQ_INT(JSON_PARSE_INVALID_VALUE, json_lazy_get_value(&e, &value));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_parse(&root, "[null7, 1 ]", 11));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_get_array_size(&root, &size));
+    EXPECT_EQ_SIZE_T(2, size);
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_get_array_element(&root, 0, &e));
+    EXPECT_EQ_INT(JSON_PARSE_INVALID_VALUE, json_lazy_get_value(&e, &value));
+    EXPECT_EQ_INT(JSON_NULL, json_get_type(&value));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_get_array_element(&root, 1, &e));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_get_value(&e, &value));
+    EXPECT_EQ_DOUBLE(1.0, json_get_number(&value));
+}
+
+static void test_parse_projected() {
+    const char* json = "{\"id\":7,\"meta\":{\"tags\":[\"a\",\"b\"],\"owner\":{\"name\":\"x\",\"age\":3}},"
+        "\"items\":[{\"id\":1,\"blob\":\"\\u00e9\\n\"},{\"id\":2,\"blob\":[null,{}]},{\"blob\":0}],\"skip\":\"\\ud834\\udd1e\"}";
+    const char* paths[] = { "/id", "/meta/owner/name", "/items/*/id", "/items/1/blob/1", "/meta/tags/0/deep" };
+    json_pointer* pointers[5];
+    json_value value, full;
+    const json_value* v;
+    char* s1, *s2;
+    size_t l1, l2;
+
+    for (size_t i = 0; i < 5; i++)
+        pointers[i] = json_pointer_compile(paths[i], strlen(paths[i]));
+    json_init(&full);
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_parse(&full, json));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_parse_projected(&value, json, strlen(json), pointers, 5));
+    EXPECT_EQ_SIZE_T(3, json_get_object_size(&value));
+    EXPECT_EQ_INT(7, (int)json_get_int64(json_pointer_find(&value, "/id", 3)));
+    EXPECT_TRUE(json_pointer_find(&value, "/skip", 5) == NULL);
+    /* 路径经过的容器保留, 路径中途的标量不保留 */
+    v = json_pointer_find(&value, "/meta", 5);
+    EXPECT_EQ_SIZE_T(2, json_get_object_size(v));
+    EXPECT_EQ_SIZE_T(2, json_get_array_size(json_pointer_find(v, "/tags", 5)));
+    EXPECT_EQ_INT(JSON_NULL, json_get_type(json_pointer_find(v, "/tags/0", 7)));
+    EXPECT_EQ_SIZE_T(1, json_get_object_size(json_pointer_find(v, "/owner", 6)));
+    EXPECT_EQ_STRING("x", json_get_string(json_pointer_find(v, "/owner/name", 11)), 1);
+    /* 数组保持长度, 跳过的元素为 null */
+    v = json_pointer_find(&value, "/items", 6);
+    EXPECT_EQ_SIZE_T(3, json_get_array_size(v));
+    EXPECT_EQ_SIZE_T(1, json_get_object_size(json_get_array_element(v, 0)));
+    EXPECT_EQ_SIZE_T(2, json_get_object_size(json_get_array_element(v, 1)));
+    EXPECT_EQ_SIZE_T(0, json_get_object_size(json_get_array_element(v, 2)));
+    EXPECT_EQ_INT(JSON_NULL, json_get_type(json_pointer_find(v, "/1/blob/0", 9)));
+    EXPECT_EQ_INT(JSON_OBJECT, json_get_type(json_pointer_find(v, "/1/blob/1", 9)));
+    json_free(&value);
+
+    /* "" 保留整个文档 */
+    json_pointer_free(pointers[4]);
+    pointers[4] = json_pointer_compile("", 0);
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_parse_projected(&value, json, strlen(json), pointers, 5));
+    json_stringify(&full, &s1, &l1);
+    json_stringify(&value, &s2, &l2);
+    EXPECT_TRUE(l1 == l2 && memcmp(s1, s2, l1) == 0);
+    free(s1);
+    free(s2);
+    json_free(&value);
+
+    /* 被跳过的部分同样要校验 */
+    EXPECT_EQ_INT(JSON_PARSE_INVALID_UNICODE_SURROGATE, json_parse_projected(&value, "{\"id\":1,\"x\":\"\\ud800\"}", 19, pointers, 1));
+    EXPECT_EQ_INT(JSON_NULL, json_get_type(&value));
+    EXPECT_EQ_INT(JSON_PARSE_ROOT_NOT_SINGULAR, json_parse_projected(&value, "{\"id\":1} 2", 10, pointers, 1));
+    EXPECT_EQ_INT(JSON_NULL, json_get_type(&value));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_parse_projected(&value, " \"str\" ", 7, pointers, 1));
+    EXPECT_EQ_INT(JSON_NULL, json_get_type(&value));
+    for (size_t i = 0; i < 5; i++)
+        json_pointer_free(pointers[i]);
+    json_free(&full);
+}
+
+static void test_parse_skip() {
+    char json[300];
+    size_t n;
+    EXPECT_EQ_SIZE_T(5, json_skip(" null, 1", 8));
+    EXPECT_EQ_SIZE_T(6, json_skip("-1.5e3]", 7));
+    EXPECT_EQ_SIZE_T(6, json_skip("\"a\\\"]\"\"", 7));
+    EXPECT_EQ_SIZE_T(18, json_skip("{\"a\":[1,{}],\"b\":2} ", 19));
+    EXPECT_EQ_SIZE_T(8, json_skip("[\"]}\\\\\"] ]", 10));
+    EXPECT_EQ_SIZE_T(0, json_skip("", 0));
+    EXPECT_EQ_SIZE_T(0, json_skip("  ", 2));
+    EXPECT_EQ_SIZE_T(0, json_skip("]", 1));
+    EXPECT_EQ_SIZE_T(0, json_skip(",", 1));
+    EXPECT_EQ_SIZE_T(0, json_skip(" :1", 3));
+    EXPECT_EQ_SIZE_T(0, json_skip("[}", 2));
+    EXPECT_EQ_SIZE_T(0, json_skip("{\"a\":[1]]", 10));
+    EXPECT_EQ_SIZE_T(0, json_skip("\"abc", 4));
+    EXPECT_EQ_SIZE_T(0, json_skip("[[1]", 4));
+    EXPECT_EQ_SIZE_T(0, json_skip("[\"]\"", 4));
+
+    /* 跨越多个 64 字节块: 字符串中的括号、块边界上的转义 */
+    n = 0;
+    json[n++] = '[';
+    for (int i = 0; i < 20; i++) {
+        memcpy(json + n, "{\"k\":\"[\\\"{\"},", 12);
+        n += 12;
+    }
+    memcpy(json + n, "\"\\\\\"]", 5);
+    n += 5;
+    EXPECT_EQ_SIZE_T(n, json_skip(json, n));
+    EXPECT_EQ_SIZE_T(0, json_skip(json, n - 1));
+    json[n] = ']';
+    EXPECT_EQ_SIZE_T(n, json_skip(json, n + 1));
+    /* 一块中右括号多于左括号, 但不足以回到深度 0 */
+    memset(json, '[', 100);
+    memset(json + 100, ']', 100);
+    EXPECT_EQ_SIZE_T(200, json_skip(json, 200));
+    EXPECT_EQ_SIZE_T(0, json_skip(json, 199));
+    for (size_t i = 62; i < 66; i++) {
+        /* 反斜杠恰好落在块末尾 */
+        memset(json, ' ', sizeof(json));
+        json[0] = '[';
+        json[i - 2] = '"';
+        json[i - 1] = '\\';
+        json[i] = '"';
+        json[i + 1] = '"';
+        json[i + 2] = ']';
+        EXPECT_EQ_SIZE_T(i + 3, json_skip(json, i + 10));
+    }
+}
+
+static void test_parse_arena() {
+    json_arena arena;
+    json_value value;
+    json_arena_init(&arena);
+
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_parse_arena(&arena, &value,
+        " { \"s\" : \"abc\", \"a\" : [ 1, \"x\\ny\", [ ] ], \"o\" : { \"k\" : null } } "));
+    EXPECT_EQ_INT(JSON_OBJECT, json_get_type(&value));
+    EXPECT_EQ_SIZE_T(3, json_get_object_size(&value));
+    EXPECT_EQ_STRING("abc", json_get_string(json_get_object_value(&value, 0)), json_get_string_length(json_get_object_value(&value, 0)));
+    EXPECT_EQ_SIZE_T(3, json_get_array_size(json_get_object_value(&value, 1)));
+    EXPECT_EQ_STRING("x\ny", json_get_string(json_get_array_element(json_get_object_value(&value, 1), 1)),
+        json_get_string_length(json_get_array_element(json_get_object_value(&value, 1), 1)));
+    EXPECT_EQ_STRING("k", json_get_object_key(json_get_object_value(&value, 2), 0), json_get_object_key_length(json_get_object_value(&value, 2), 0));
+    json_arena_reset(&arena);
+
+    /* 出错时已分配的部分留在 arena 中 */
+    EXPECT_EQ_INT(JSON_PARSE_MISS_COMMA_OR_CURLY_BRACKET, json_parse_arena(&arena, &value, "{\"a\":[\"b\"],\"c\":1"));
+    EXPECT_EQ_INT(JSON_NULL, json_get_type(&value));
+    EXPECT_EQ_INT(JSON_PARSE_ROOT_NOT_SINGULAR, json_parse_arena(&arena, &value, "[\"abc\"] x"));
+    EXPECT_EQ_INT(JSON_NULL, json_get_type(&value));
+    json_arena_free(&arena);
+}
+
+static void test_parse_insitu() {
+    json_arena arena;
+    json_value value;
+    char json[] = "{\"k\\u0041\":[\"a\\tb\",\"\\uD834\\uDD1E\",\"plain\"]}";
+    json_arena_init(&arena);
+
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_parse_insitu(&arena, &value, json, sizeof(json) - 1));
+    EXPECT_EQ_INT(JSON_OBJECT, json_get_type(&value));
+    EXPECT_EQ_STRING("kA", json_get_object_key(&value, 0), json_get_object_key_length(&value, 0));
+    EXPECT_TRUE(json_get_object_key(&value, 0) == json + 2); /* 指向输入缓冲区 */
+    {
+        json_value* a = json_get_object_value(&value, 0);
+        EXPECT_EQ_SIZE_T(3, json_get_array_size(a));
+        EXPECT_EQ_STRING("a\tb", json_get_string(json_get_array_element(a, 0)), json_get_string_length(json_get_array_element(a, 0)));
+        EXPECT_EQ_STRING("\xF0\x9D\x84\x9E", json_get_string(json_get_array_element(a, 1)), json_get_string_length(json_get_array_element(a, 1)));
+        EXPECT_EQ_STRING("plain", json_get_string(json_get_array_element(a, 2)), json_get_string_length(json_get_array_element(a, 2)));
+        EXPECT_EQ_INT('\0', json_get_string(json_get_array_element(a, 2))[5]);
+    }
+    json_arena_free(&arena);
+}
+
 #define TEST_ERROR(error, json)\
     do {\
         json_value value;\
@@ -232,6 +971,10 @@ static void test_parse_object() {
         EXPECT_EQ_INT(error, json_parse(&value, json));\
         EXPECT_EQ_INT(JSON_NULL, json_get_type(&value));\
         json_free(&value);\
+        /* 不保留任何路径时所有值都走跳过校验 */\
+        EXPECT_EQ_INT(error, json_parse_projected(&value, json, strlen(json), NULL, 0));\
+        EXPECT_EQ_INT(JSON_NULL, json_get_type(&value));\
+        EXPECT_EQ_INT(error, json_validate(json, strlen(json)));\
     } while(0)
 
 static void test_parse_expect_value() {
@@ -274,6 +1017,7 @@ static void test_parse_number_too_big() {
 static void test_parse_missing_quotation_mark() {
     TEST_ERROR(JSON_PARSE_MISS_QUOTATION_MARK, "\"");
     TEST_ERROR(JSON_PARSE_MISS_QUOTATION_MARK, "\"abc");
+    TEST_ERROR(JSON_PARSE_MISS_QUOTATION_MARK, "\"0123456789abcdef0123456789abcdef0123");
 }
 
 static void test_parse_invalid_string_escape() {
@@ -286,6 +1030,7 @@ static void test_parse_invalid_string_escape() {
 static void test_parse_invalid_string_char() {
     TEST_ERROR(JSON_PARSE_INVALID_STRING_CHAR, "\"\x01\"");
     TEST_ERROR(JSON_PARSE_INVALID_STRING_CHAR, "\"\x1F\"");
+    TEST_ERROR(JSON_PARSE_INVALID_STRING_CHAR, "\"0123456789abcdef0123456789\x1F\"");
 }
 
 static void test_parse_invalid_unicode_hex() {
@@ -351,6 +1096,7 @@ static void test_parse_miss_comma_or_curly_bracket() {
         size_t length;\
         json_init(&value);\
         EXPECT_EQ_INT(JSON_PARSE_OK, json_parse(&value, json));\
+        EXPECT_EQ_INT(JSON_PARSE_OK, json_validate(json, strlen(json)));\
         EXPECT_EQ_INT(JSON_STRINGIFY_OK, json_stringify(&value, &json2, &length));\
         EXPECT_EQ_STRING(json, json2, length);\
         json_free(&value);\
@@ -365,15 +1111,25 @@ static void test_stringify_number() {
     TEST_ROUNDTRIP("1.5");
     TEST_ROUNDTRIP("-1.5");
     TEST_ROUNDTRIP("3.25");
-    // TEST_ROUNDTRIP("1e+20");
-    // TEST_ROUNDTRIP("1.234e+20");
-    // TEST_ROUNDTRIP("1.234e-20");
+    TEST_ROUNDTRIP("1e+20");
+    TEST_ROUNDTRIP("1.234e+20");
+    TEST_ROUNDTRIP("1.234e-20");
+    TEST_ROUNDTRIP("0.1");
+    TEST_ROUNDTRIP("0.0001");
+    TEST_ROUNDTRIP("1e-05");
+    TEST_ROUNDTRIP("123456.789");
+    TEST_ROUNDTRIP("9007199254740991");
+    TEST_ROUNDTRIP("1e+17");
+    TEST_ROUNDTRIP("10000000000000000");
+    TEST_ROUNDTRIP("9007199254740993");
+    TEST_ROUNDTRIP("9223372036854775807");
+    TEST_ROUNDTRIP("-9223372036854775808");
 
     TEST_ROUNDTRIP("1.0000000000000002"); /* the smallest number > 1 */
-    TEST_ROUNDTRIP("4.9406564584124654e-324"); /* minimum denormal */
-    TEST_ROUNDTRIP("-4.9406564584124654e-324");
-    TEST_ROUNDTRIP("2.2250738585072009e-308");  /* Max subnormal double */
-    TEST_ROUNDTRIP("-2.2250738585072009e-308");
+    TEST_ROUNDTRIP("5e-324"); /* minimum denormal */
+    TEST_ROUNDTRIP("-5e-324");
+    TEST_ROUNDTRIP("2.225073858507201e-308");  /* Max subnormal double */
+    TEST_ROUNDTRIP("-2.225073858507201e-308");
     TEST_ROUNDTRIP("2.2250738585072014e-308");  /* Min normal positive double */
     TEST_ROUNDTRIP("-2.2250738585072014e-308");
     TEST_ROUNDTRIP("1.7976931348623157e+308");  /* Max double */
@@ -386,6 +1142,9 @@ static void test_stringify_string() {
     TEST_ROUNDTRIP("\"Hello\\nWorld\"");
     TEST_ROUNDTRIP("\"\\\" \\\\ / \\b \\f \\n \\r \\t\"");
     TEST_ROUNDTRIP("\"Hello\\u0000World\"");
+    /* 长串中的转义落在 SIMD 块的各个位置 */
+    TEST_ROUNDTRIP("\"0123456789abcdef0123456789abcdef\\\"0123456789abcdef0123456789abcde\\n\"");
+    TEST_ROUNDTRIP("\"\\u001F0123456789abcdef\\\\0123456789abcdef0123456789abcdef0123456789abcdef\\t\"");
 }
 
 static void test_stringify_array() {
@@ -398,6 +1157,138 @@ static void test_stringify_object() {
     TEST_ROUNDTRIP("{\"n\":null,\"f\":false,\"t\":true,\"i\":123,\"s\":\"abc\",\"a\":[1,2,3],\"o\":{\"1\":1,\"2\":2,\"3\":3}}");
 }
 
+static void test_stringify_writer() {
+    json_writer* writer = json_writer_create();
+    char* json;
+    size_t length;
+
+    json_writer_begin_object(writer);
+    json_writer_key(writer, "n", 1);
+    json_writer_null(writer);
+    json_writer_key(writer, "f", 1);
+    json_writer_boolean(writer, 0);
+    json_writer_key(writer, "t", 1);
+    json_writer_boolean(writer, 1);
+    json_writer_key(writer, "i", 1);
+    json_writer_int64(writer, 123);
+    json_writer_key(writer, "d", 1);
+    json_writer_number(writer, 1.5);
+    json_writer_key(writer, "s", 1);
+    json_writer_string(writer, "a\"b\n\x01", 5);
+    json_writer_key(writer, "a", 1);
+    json_writer_begin_array(writer);
+    json_writer_begin_array(writer);
+    json_writer_end_array(writer);
+    json_writer_begin_object(writer);
+    json_writer_end_object(writer);
+    json_writer_number(writer, 1e20);
+    json_writer_end_array(writer);
+    json_writer_end_object(writer);
+    EXPECT_EQ_INT(JSON_STRINGIFY_OK, json_writer_finish(writer, &json, &length));
+    EXPECT_EQ_STRING("{\"n\":null,\"f\":false,\"t\":true,\"i\":123,\"d\":1.5,\"s\":\"a\\\"b\\n\\u0001\",\"a\":[[],{},1e+20]}", json, length);
+    free(json);
+
+    /* finish() 之后可以继续写下一个文档 */
+    json_writer_string(writer, NULL, 0);
+    EXPECT_EQ_INT(JSON_STRINGIFY_OK, json_writer_finish(writer, &json, &length));
+    EXPECT_EQ_STRING("\"\"", json, length);
+    free(json);
+    json_writer_destroy(writer);
+}
+
+typedef struct {
+    char* buf;
+    size_t len, calls, max_write;
+    int fail_after; /* 第几次调用时失败, 0 为不失败 */
+} sink_buffer;
+
+static int sink_append(void* user, const char* data, size_t len) {
+    sink_buffer* s = (sink_buffer*)user;
+    if (++s->calls == (size_t)s->fail_after)
+        return 1;
+    s->buf = (char*)realloc(s->buf, s->len + len);
+    memcpy(s->buf + s->len, data, len);
+    s->len += len;
+    if (len > s->max_write)
+        s->max_write = len;
+    return 0;
+}
+
+static void test_stringify_sink() {
+    json_value value, *e;
+    sink_buffer s;
+    char* json, *str, line[64];
+    size_t length, n = 100000;
+    FILE* fp;
+
+    /* 超过缓冲区大小的数组和字符串 */
+    json_init(&value);
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_parse(&value, "[\"\",1.5,{\"k\":[true,null]}]"));
+    str = (char*)malloc(n);
+    for (size_t i = 0; i < n; i++)
+        str[i] = "ab\"\n\x01"[i % 5];
+    e = json_get_array_element(&value, 0);
+    json_set_string(e, str, n);
+    free(str);
+    EXPECT_EQ_INT(JSON_STRINGIFY_OK, json_stringify(&value, &json, &length));
+
+    memset(&s, 0, sizeof(s));
+    EXPECT_EQ_INT(JSON_STRINGIFY_OK, json_stringify_to_sink(&value, sink_append, &s));
+    EXPECT_TRUE(s.len == length && memcmp(s.buf, json, length) == 0);
+    EXPECT_TRUE(s.calls > 1 && s.max_write <= 4096);
+    free(s.buf);
+
+    memset(&s, 0, sizeof(s));
+    s.fail_after = 2;
+    EXPECT_EQ_INT(JSON_STRINGIFY_WRITE_ERROR, json_stringify_to_sink(&value, sink_append, &s));
+    free(s.buf);
+    free(json);
+    json_free(&value);
+
+    if ((fp = tmpfile()) != NULL) {
+        EXPECT_EQ_INT(JSON_PARSE_OK, json_parse(&value, "{\"a\":[1,\"x\"]}"));
+        EXPECT_EQ_INT(JSON_STRINGIFY_OK, json_stringify_to_file(&value, fp));
+        fflush(fp);
+        EXPECT_EQ_INT(JSON_STRINGIFY_OK, json_stringify_to_fd(&value, fileno(fp)));
+        rewind(fp);
+        length = fread(line, 1, sizeof(line), fp);
+        EXPECT_EQ_STRING("{\"a\":[1,\"x\"]}{\"a\":[1,\"x\"]}", line, length);
+        json_free(&value);
+        fclose(fp);
+    }
+}
+
+#define TEST_STRINGIFY_SIZE(json)\
+    do {\
+        json_value value;\
+        char buf[256];\
+        size_t length = 0;\
+        json_init(&value);\
+        EXPECT_EQ_INT(JSON_PARSE_OK, json_parse(&value, json));\
+        EXPECT_EQ_SIZE_T(sizeof(json) - 1, json_stringify_size(&value));\
+        EXPECT_EQ_INT(JSON_STRINGIFY_BUFFER_TOO_SMALL, json_stringify_into(&value, buf, sizeof(json) - 1, &length));\
+        EXPECT_EQ_SIZE_T(sizeof(json) - 1, length);\
+        EXPECT_EQ_INT(JSON_STRINGIFY_OK, json_stringify_into(&value, buf, sizeof(json), &length));\
+        EXPECT_EQ_STRING(json, buf, length);\
+        EXPECT_EQ_INT('\0', buf[length]);\
+        json_free(&value);\
+    } while(0)
+
+static void test_stringify_size() {
+    TEST_STRINGIFY_SIZE("null");
+    TEST_STRINGIFY_SIZE("false");
+    TEST_STRINGIFY_SIZE("-1.2345e-100");
+    TEST_STRINGIFY_SIZE("-9223372036854775808");
+    TEST_STRINGIFY_SIZE("\"\"");
+    TEST_STRINGIFY_SIZE("\"\\\" \\\\ / \\b \\f \\n \\r \\t \\u0001 \\u001F\"");
+    TEST_STRINGIFY_SIZE("[]");
+    TEST_STRINGIFY_SIZE("[1]");
+    TEST_STRINGIFY_SIZE("[null,false,true,123,\"abc\",[1,2,3]]");
+    TEST_STRINGIFY_SIZE("{}");
+    TEST_STRINGIFY_SIZE("{\"\\n\":{}}");
+    TEST_STRINGIFY_SIZE("{\"n\":null,\"f\":false,\"t\":true,\"i\":123,\"s\":\"abc\",\"a\":[1,2,3],\"o\":{\"1\":1,\"2\":2,\"3\":3}}");
+}
+
 static void test_stringify() {
     TEST_ROUNDTRIP("null");
     TEST_ROUNDTRIP("false");
@@ -406,6 +1297,9 @@ static void test_stringify() {
     test_stringify_string();
     test_stringify_array();
     test_stringify_object();
+    test_stringify_writer();
+    test_stringify_sink();
+    test_stringify_size();
 }
 
 static void test_parse() {
@@ -413,9 +1307,25 @@ static void test_parse() {
     test_parse_true();
     test_parse_false();
     test_parse_number();
+    test_parse_int64();
     test_parse_string();
     test_parse_array();
     test_parse_object();
+    test_find_object();
+    test_parse_sax();
+    test_parse_incremental();
+    test_parse_n();
+    test_parse_context();
+    test_parse_file();
+    test_parse_ndjson();
+    test_parse_parallel();
+    test_parse_indexed();
+    test_parse_tape();
+    test_parse_lazy();
+    test_parse_projected();
+    test_parse_skip();
+    test_parse_arena();
+    test_parse_insitu();
     test_stringify();
 
     test_parse_expect_value();
@@ -434,6 +1344,57 @@ static void test_parse() {
     test_parse_miss_comma_or_curly_bracket();
 }
 
+static void test_pointer() {
+    /* RFC 6901 第 5 节的例子 */
+    const char* json = "{\"foo\":[\"bar\",\"baz\"],\"\":0,\"a/b\":1,\"c%d\":2,\"e^f\":3,\"g|h\":4,\"i\\\\j\":5,"
+        "\"k\\\"l\":6,\" \":7,\"m~n\":8,\"arr\":[[0,1],{\"10\":\"ten\"}]}";
+    static const char* paths[] = { "/", "/a~1b", "/c%d", "/e^f", "/g|h", "/i\\j", "/k\"l", "/ ", "/m~0n" };
+    json_value root;
+    json_pointer* pointer;
+    json_lazy lazy, result;
+    json_value value;
+
+    json_init(&root);
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_parse(&root, json));
+    EXPECT_TRUE(json_pointer_find(&root, "", 0) == &root);
+    EXPECT_EQ_SIZE_T(2, json_get_array_size(json_pointer_find(&root, "/foo", 4)));
+    EXPECT_EQ_STRING("baz", json_get_string(json_pointer_find(&root, "/foo/1", 6)), 3);
+    EXPECT_EQ_STRING("ten", json_get_string(json_pointer_find(&root, "/arr/1/10", 9)), 3);
+    EXPECT_EQ_DOUBLE(1.0, json_get_number(json_pointer_find(&root, "/arr/0/1", 8)));
+    for (size_t i = 0; i < sizeof(paths) / sizeof(paths[0]); i++)
+        EXPECT_EQ_DOUBLE((double)i, json_get_number(json_pointer_find(&root, paths[i], strlen(paths[i]))));
+
+    /* 不存在 */
+    EXPECT_TRUE(json_pointer_find(&root, "/foo/2", 6) == NULL);
+    EXPECT_TRUE(json_pointer_find(&root, "/foo/-", 6) == NULL);
+    EXPECT_TRUE(json_pointer_find(&root, "/foo/01", 7) == NULL);
+    EXPECT_TRUE(json_pointer_find(&root, "/foo/0/x", 8) == NULL);
+    EXPECT_TRUE(json_pointer_find(&root, "/x", 2) == NULL);
+    /* 非法路径 */
+    EXPECT_TRUE(json_pointer_compile("foo", 3) == NULL);
+    EXPECT_TRUE(json_pointer_compile("/~2", 3) == NULL);
+    EXPECT_TRUE(json_pointer_compile("/a~", 3) == NULL);
+
+    /* 编译一次, 在 json_value 和惰性文档上求值 */
+    pointer = json_pointer_compile("/arr/1/10", 9);
+    EXPECT_TRUE(json_pointer_get(pointer, &root) == json_find_object_value(json_get_array_element(json_find_object_value(&root, "arr", 3), 1), "10", 2));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_parse(&lazy, json, strlen(json)));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_pointer_get_lazy(pointer, &lazy, &result));
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_lazy_get_value(&result, &value));
+    EXPECT_EQ_STRING("ten", json_get_string(&value), json_get_string_length(&value));
+    json_free(&value);
+    json_pointer_free(pointer);
+    pointer = json_pointer_compile("/k\"l", 4);
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_pointer_get_lazy(pointer, &lazy, &result));
+    EXPECT_EQ_INT(JSON_NUMBER, json_lazy_get_type(&result));
+    json_pointer_free(pointer);
+    pointer = json_pointer_compile("/foo/bar", 8);
+    EXPECT_EQ_INT(JSON_PARSE_OK, json_pointer_get_lazy(pointer, &lazy, &result));
+    EXPECT_TRUE(result.json == NULL);
+    json_pointer_free(pointer);
+    json_free(&root);
+}
+
 static void test_access_null() {
     json_value value;
     json_init(&value);
@@ -459,6 +1420,17 @@ static void test_access_number() {
     EXPECT_EQ_DOUBLE(1.1, json_get_number(&value));
 }
 
+static void test_access_int64() {
+    json_value value;
+    json_init(&value);
+    json_set_int64(&value, -9007199254740993LL);
+    EXPECT_TRUE(json_is_int64(&value));
+    EXPECT_EQ_INT64(-9007199254740993LL, json_get_int64(&value));
+    json_set_number(&value, 1.5);
+    EXPECT_FALSE(json_is_int64(&value));
+    json_free(&value);
+}
+
 static void test_access_string() {
     json_value value;
     json_init(&value);
@@ -473,7 +1445,9 @@ static void test_access() {
     test_access_null();
     test_access_boolean();
     test_access_number();
+    test_access_int64();
     test_access_string();
+    test_pointer();
 }
 
 int main() {
@@ -482,6 +1456,9 @@ int main() {
 #endif
     
     test_parse();
+    parse_indexed = 1;
+    test_parse();
+    parse_indexed = 0;
     test_access();
     printf("%d/%d (%3.2f%%) passed\n", test_pass, test_count, test_pass * 100.0 / test_count);
     return main_ret;